@@ -496,6 +496,15 @@ void AIModule::setWeaponPickedUp()
 	_weaponPickedUp = true;
 }
 
+/**
+ * Sets the faction the unit considers its enemy.
+ * @param faction Faction to target.
+ */
+void AIModule::setTargetFaction(UnitFaction faction)
+{
+	_targetFaction = faction;
+}
+
 /*
  * Gets whether the unit was hit.
  * @return if it was hit.
@@ -1109,7 +1118,9 @@ int AIModule::getSpottingUnits(const Position& pos) const
 	// if we don't actually occupy the position being checked, we need to do a virtual LOF check.
 	bool checking = pos != _unit->getPosition();
 	int tally = 0;
-	for (std::vector<BattleUnit*>::const_iterator i = _save->getUnits()->begin(); i != _save->getUnits()->end(); ++i)
+	std::vector<BattleUnit*> candidates;
+	_save->getUnitsInRange(pos, 20, candidates);
+	for (std::vector<BattleUnit*>::const_iterator i = candidates.begin(); i != candidates.end(); ++i)
 	{
 		if (validTarget(*i, false, false))
 		{
@@ -1148,7 +1159,10 @@ int AIModule::selectNearestTarget()
 	_closestDist= 100;
 	_aggroTarget = 0;
 	Position target;
-	for (std::vector<BattleUnit*>::const_iterator i = _save->getUnits()->begin(); i != _save->getUnits()->end(); ++i)
+	// nothing beyond the global max view distance is visible
+	std::vector<BattleUnit*> candidates;
+	_save->getUnitsInRange(_unit->getPosition(), _save->getMod()->getMaxViewDistance(), candidates);
+	for (std::vector<BattleUnit*>::const_iterator i = candidates.begin(); i != candidates.end(); ++i)
 	{
 		if (validTarget(*i, true, _unit->getFaction() == FACTION_HOSTILE) &&
 			_save->getTileEngine()->visible(_unit, (*i)->getTile()))
@@ -77,6 +77,8 @@ public:
 	void setWasHitBy(BattleUnit *attacker);
 	/// Sets the "unit picked up a weapon" flag.
 	void setWeaponPickedUp();
+	/// Sets the faction the unit fights against.
+	void setTargetFaction(UnitFaction faction);
 	/// Gets whether the unit was hit.
 	bool getWasHitBy(int attacker) const;
 	/// setup a patrol objective.
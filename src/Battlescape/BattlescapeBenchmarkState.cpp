@@ -0,0 +1,265 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "BattlescapeBenchmarkState.h"
+#include <iomanip>
+#include <sstream>
+#include <yaml-cpp/yaml.h>
+#include "BattlescapeGame.h"
+#include "BattlescapeState.h"
+#include "../Engine/Game.h"
+#include "../Engine/Exception.h"
+#include "../Engine/Logger.h"
+#include "../Engine/Options.h"
+#include "../Engine/RNG.h"
+#include "../Engine/Screen.h"
+#include "../Mod/MapData.h"
+#include "../Savegame/BattleUnit.h"
+#include "../Savegame/SavedBattleGame.h"
+#include "../Savegame/SavedGame.h"
+
+namespace OpenXcom
+{
+
+/// Number of battle state updates after which a turn is considered stuck.
+const int MAX_TURN_STEPS = 1000000;
+
+/**
+ * Initializes the benchmark.
+ * @param filename Save filename, relative to the master user folder.
+ * @param turns Maximum number of turns to play.
+ * @param seed RNG seed to run with, 0 to keep the one in the save.
+ */
+BattlescapeBenchmarkState::BattlescapeBenchmarkState(const std::string &filename, int turns, uint64_t seed) : _filename(filename), _turns(turns), _turn(-1), _seed(seed), _battle(0)
+{
+	_counters.push_back(BenchmarkCounter("whole turn"));
+}
+
+/**
+ *
+ */
+BattlescapeBenchmarkState::~BattlescapeBenchmarkState()
+{
+	Benchmark::enableSections(false);
+	delete _battle;
+}
+
+/**
+ * Loads the saved game and sets up the battlescape
+ * so the AI controls every unit.
+ * @return True if the save could be used.
+ */
+bool BattlescapeBenchmarkState::load()
+{
+	SavedGame *save = new SavedGame();
+	try
+	{
+		save->load(_filename, _game->getMod(), _game->getLanguage());
+	}
+	catch (Exception &e)
+	{
+		Log(LOG_ERROR) << "Battlescape benchmark: can't load " << _filename << ": " << e.what();
+		delete save;
+		return false;
+	}
+	catch (YAML::Exception &e)
+	{
+		Log(LOG_ERROR) << "Battlescape benchmark: can't load " << _filename << ": " << e.what();
+		delete save;
+		return false;
+	}
+	if (save->getSavedBattle() == 0)
+	{
+		Log(LOG_ERROR) << "Battlescape benchmark: " << _filename << " is not a battlescape save.";
+		delete save;
+		return false;
+	}
+
+	// never let the run overwrite the player's saves
+	save->setIronman(false);
+	_game->setSavedGame(save);
+	SavedBattleGame *battle = save->getSavedBattle();
+	battle->loadMapResources(_game->getMod());
+	Options::baseXResolution = Options::baseXBattlescape;
+	Options::baseYResolution = Options::baseYBattlescape;
+	_game->getScreen()->resetDisplay(false);
+	_battle = new BattlescapeState;
+	battle->setBattleState(_battle);
+	_battle->getBattleGame()->setAutoPlay(true);
+	if (_seed != 0)
+	{
+		RNG::setSeed(_seed);
+	}
+	Log(LOG_INFO) << "Battlescape benchmark: " << _filename << ", turn " << battle->getTurn() << ", up to " << _turns << " turns, seed " << RNG::getSeed();
+	_battle->getBattleGame()->init();
+	Benchmark::enableSections(true);
+	return true;
+}
+
+/**
+ * Runs the battle until the next turn starts, the same way
+ * BattlescapeState::think() does but without waiting for
+ * animations, and logs how long it took.
+ * The next turn screen is handled like a player closing it,
+ * any other popup is thrown away.
+ * @return False if the turn got stuck.
+ */
+bool BattlescapeBenchmarkState::runTurn()
+{
+	SavedBattleGame *battle = _game->getSavedGame()->getSavedBattle();
+	BattlescapeGame *battleGame = _battle->getBattleGame();
+	const int turn = battle->getTurn();
+	const std::vector<BenchmarkCounter> before = Benchmark::getSections();
+	const uint64_t nanoseconds = _counters[0].nanoseconds;
+	int steps = 0;
+	{
+		BenchmarkScope scope(_counters[0]);
+		while (battle->getTurn() == turn && !_battle->isBattleFinished())
+		{
+			if (++steps > MAX_TURN_STEPS)
+			{
+				Log(LOG_ERROR) << "Battlescape benchmark: turn " << turn << " is stuck.";
+				return false;
+			}
+			battleGame->think();
+			battleGame->handleState();
+			_battle->discardPopups();
+			if (!_game->isState(this))
+			{
+				// only the next turn screen is pushed over us
+				while (!_game->isState(this))
+				{
+					_game->popState();
+				}
+				battleGame->cleanupDeleted();
+				BattlescapeTally tally = battleGame->tallyUnits();
+				if (battleGame->areAllEnemiesNeutralized())
+				{
+					tally.liveAliens = 0;
+				}
+				if ((battle->getObjectiveType() != MUST_DESTROY && tally.liveAliens == 0) || tally.liveSoldiers == 0)
+				{
+					_battle->finishBattle(false, tally.liveSoldiers);
+				}
+			}
+		}
+	}
+
+	const std::vector<BenchmarkCounter> &after = Benchmark::getSections();
+	std::ostringstream ss;
+	ss << "Battlescape benchmark: turn " << turn << ": " << steps << " steps, " << std::fixed << std::setprecision(3) << (_counters[0].nanoseconds - nanoseconds) / 1e6 << " ms";
+	for (int i = 0; i < BENCHMARK_SECTIONS; ++i)
+	{
+		ss << ", " << after[i].name << " " << (after[i].nanoseconds - before[i].nanoseconds) / 1e6 << " ms";
+	}
+	Log(LOG_INFO) << ss.str();
+	return true;
+}
+
+/**
+ * Hashes the turn, the RNG state, the item count and the
+ * state of every unit, which is enough to tell apart battles
+ * that played out differently.
+ * @return 64 bit FNV-1a hash.
+ */
+uint64_t BattlescapeBenchmarkState::getOutcomeHash() const
+{
+	uint64_t hash = 14695981039346656037ULL;
+	auto mix = [&](int64_t value)
+	{
+		for (int i = 0; i < 8; ++i)
+		{
+			hash ^= (uint64_t)(value >> (i * 8)) & 0xFF;
+			hash *= 1099511628211ULL;
+		}
+	};
+	SavedBattleGame *battle = _game->getSavedGame()->getSavedBattle();
+	mix(battle->getTurn());
+	mix(battle->getSide());
+	mix(RNG::getSeed());
+	mix(battle->getItems()->size());
+	for (const auto *unit : *battle->getUnits())
+	{
+		mix(unit->getId());
+		mix(unit->getFaction());
+		mix(unit->getStatus());
+		mix(unit->getHealth());
+		mix(unit->getStunlevel());
+		mix(unit->getPosition().x);
+		mix(unit->getPosition().y);
+		mix(unit->getPosition().z);
+	}
+	return hash;
+}
+
+/**
+ * Logs the total time spent in every engine section,
+ * and the outcome of the battle.
+ */
+void BattlescapeBenchmarkState::report()
+{
+	std::vector<BenchmarkCounter> counters = _counters;
+	for (const auto &c : Benchmark::getSections())
+	{
+		counters.push_back(c);
+	}
+	Benchmark::report("Battlescape benchmark: " + std::to_string(_turn) + " turns played", counters);
+
+	BattlescapeTally tally = _battle->getBattleGame()->tallyUnits();
+	std::ostringstream ss;
+	ss << "Battlescape benchmark: " << (_battle->isBattleFinished() ? "battle finished" : "battle unfinished")
+		<< ", " << tally.liveSoldiers << " soldiers and " << tally.liveAliens << " aliens alive"
+		<< ", outcome hash " << std::hex << std::setfill('0') << std::setw(16) << getOutcomeHash();
+	Log(LOG_INFO) << ss.str();
+}
+
+/**
+ * Loads the save on the first frame, then plays one turn
+ * per frame so the game can clean up the states pushed
+ * meanwhile, and quits when done.
+ */
+void BattlescapeBenchmarkState::think()
+{
+	State::think();
+	if (_turn < 0)
+	{
+		if (!load())
+		{
+			_game->quit();
+			return;
+		}
+		_turn = 0;
+	}
+	else if (_turn < _turns && !_battle->isBattleFinished())
+	{
+		if (!runTurn())
+		{
+			report();
+			_game->quit();
+			return;
+		}
+		_turn++;
+	}
+	else
+	{
+		report();
+		_game->quit();
+	}
+}
+
+}
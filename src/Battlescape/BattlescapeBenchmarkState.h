@@ -0,0 +1,63 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string>
+#include <vector>
+#include "../Engine/State.h"
+#include "../Engine/Benchmark.h"
+
+namespace OpenXcom
+{
+
+class BattlescapeState;
+
+/**
+ * Plays a saved battle with the AI controlling every side,
+ * as fast as possible and without rendering, and logs the
+ * time spent in the battlescape engine every turn.
+ * Ends with a hash of the battle's outcome, so runs
+ * of different builds can be checked for determinism.
+ */
+class BattlescapeBenchmarkState : public State
+{
+private:
+	std::string _filename;
+	int _turns, _turn;
+	uint64_t _seed;
+	BattlescapeState *_battle;
+	std::vector<BenchmarkCounter> _counters;
+
+	/// Loads the saved battle.
+	bool load();
+	/// Plays one turn.
+	bool runTurn();
+	/// Gets a hash of the battle's state.
+	uint64_t getOutcomeHash() const;
+	/// Logs the results.
+	void report();
+public:
+	/// Creates the Battlescape Benchmark state.
+	BattlescapeBenchmarkState(const std::string &filename, int turns, uint64_t seed);
+	/// Cleans up the Battlescape Benchmark state.
+	~BattlescapeBenchmarkState();
+	/// Runs the benchmark.
+	void think() override;
+};
+
+}
@@ -178,7 +178,7 @@ bool BattleActionCost::spendTU(std::string *message)
 BattlescapeGame::BattlescapeGame(SavedBattleGame *save, BattlescapeState *parentState) :
 	_save(save), _parentState(parentState),
 	_playerPanicHandled(true), _AIActionCounter(0), _AISecondMove(false), _playedAggroSound(false),
-	_endTurnRequested(false), _endConfirmationHandled(false), _allEnemiesNeutralized(false)
+	_endTurnRequested(false), _endConfirmationHandled(false), _allEnemiesNeutralized(false), _autoPlay(false)
 {
 
 	_currentAction.actor = 0;
@@ -220,8 +220,8 @@ void BattlescapeGame::think()
 			_save->setUnitsFalling(false);
 			return;
 		}
-		// it's a non player side (ALIENS or CIVILIANS)
-		if (_save->getSide() != FACTION_PLAYER)
+		// it's a non player side (ALIENS or CIVILIANS), or the AI plays for everyone
+		if (_save->getSide() != FACTION_PLAYER || _autoPlay)
 		{
 			_save->resetUnitHitStates();
 			if (!_debugPlay)
@@ -326,6 +326,11 @@ void BattlescapeGame::handleAI(BattleUnit *unit)
 		// for some reason the unit had no AI routine assigned..
 		unit->setAIModule(new AIModule(_save, unit, 0));
 		ai = unit->getAIModule();
+		if (_autoPlay && unit->getFaction() == FACTION_PLAYER)
+		{
+			// in autoplay, player units fight the aliens
+			ai->setTargetFaction(FACTION_HOSTILE);
+		}
 	}
 	_AIActionCounter++;
 	if (_AIActionCounter == 1)
@@ -2404,7 +2409,8 @@ BattleItem *BattlescapeGame::surveyItems(BattleAction *action, bool pickUpWeapon
 	std::vector<BattleItem*> droppedItems;
 
 	// first fill a vector with items on the ground that were dropped on the alien turn, and have an attraction value.
-	for (std::vector<BattleItem*>::iterator i = _save->getItems()->begin(); i != _save->getItems()->end(); ++i)
+	const std::vector<BattleItem*> &attractiveItems = _save->getAttractiveItems();
+	for (std::vector<BattleItem*>::const_iterator i = attractiveItems.begin(); i != attractiveItems.end(); ++i)
 	{
 		if ((*i)->getRules()->getAttraction())
 		{
@@ -2843,9 +2849,7 @@ int BattlescapeGame::checkForProximityGrenades(BattleUnit *unit)
 	// death trap?
 	if (unit->getTile()->getFloorSpecialTileType() >= DEATH_TRAPS)
 	{
-		std::ostringstream ss;
-		ss << "STR_DEATH_TRAP_" << unit->getTile()->getFloorSpecialTileType();
-		auto deathTrapRule = getMod()->getItem(ss.str());
+		auto deathTrapRule = getMod()->getDeathTrap(unit->getTile()->getFloorSpecialTileType());
 		if (deathTrapRule && (deathTrapRule->getBattleType() == BT_PROXIMITYGRENADE || deathTrapRule->getBattleType() == BT_MELEE))
 		{
 			BattleItem* deathTrapItem = nullptr;
@@ -162,6 +162,7 @@ private:
 	bool _endTurnRequested;
 	bool _endConfirmationHandled;
 	bool _allEnemiesNeutralized;
+	bool _autoPlay;
 
 	SingleRun _endTurnProcessed;
 	SingleRun _triggerProcessed;
@@ -302,6 +303,10 @@ public:
 	void autoEndBattle();
 	/// Were all enemies neutralized?
 	bool areAllEnemiesNeutralized() const { return _allEnemiesNeutralized; }
+	/// Lets the AI play the player's side too.
+	void setAutoPlay(bool autoPlay) { _autoPlay = autoPlay; }
+	/// Is the AI playing the player's side too?
+	bool isAutoPlay() const { return _autoPlay; }
 	/// Resets the flag.
 	void resetAllEnemiesNeutralized() { _allEnemiesNeutralized = false; }
 };
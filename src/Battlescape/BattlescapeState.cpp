@@ -21,6 +21,7 @@
 #include <iomanip>
 #include <SDL_gfxPrimitives.h>
 #include "Map.h"
+#include "UnitSprite.h"
 #include "Camera.h"
 #include "BattlescapeState.h"
 #include "AbortMissionState.h"
@@ -43,6 +44,7 @@
 #include "../fmath.h"
 #include "../Geoscape/SelectMusicTrackState.h"
 #include "../Engine/Game.h"
+#include "../Engine/Collections.h"
 #include "../Engine/Options.h"
 #include "../Engine/LocalizedText.h"
 #include "../Engine/Palette.h"
@@ -98,7 +100,7 @@ BattlescapeState::BattlescapeState() :
 	_isMouseScrolling(false), _isMouseScrolled(false),
 	_xBeforeMouseScrolling(0), _yBeforeMouseScrolling(0),
 	_totalMouseMoveX(0), _totalMouseMoveY(0), _mouseMovedOverThreshold(0), _mouseOverIcons(false),
-	_autosave(false),
+	_autosave(false), _battleFinished(false),
 	_numberOfDirectlyVisibleUnits(0), _numberOfEnemiesTotal(0), _numberOfEnemiesTotalPlusWounded(0)
 {
 	std::fill_n(_visibleUnit, 10, (BattleUnit*)(0));
@@ -2926,6 +2928,15 @@ void BattlescapeState::popup(State *state)
 	_popups.push_back(state);
 }
 
+/**
+ * Throws away the popups waiting to be shown,
+ * for battles played without a player.
+ */
+void BattlescapeState::discardPopups()
+{
+	Collections::deleteAll(_popups);
+}
+
 /**
  * Finishes up the current battle, shuts down the battlescape
  * and presents the debriefing screen for the mission.
@@ -2934,6 +2945,14 @@ void BattlescapeState::popup(State *state)
  */
 void BattlescapeState::finishBattle(bool abort, int inExitArea)
 {
+	// the composed units won't be drawn again, and their units go away with the battle
+	_map->getUnitSpriteCache()->clear();
+	if (_battleGame->isAutoPlay())
+	{
+		// nobody to debrief, whoever runs the autoplay takes over from here
+		_battleFinished = true;
+		return;
+	}
 	while (!_game->isState(this))
 	{
 		_game->popState();
@@ -92,7 +92,7 @@ private:
 	std::string _currentTooltip;
 	Position _cursorPosition;
 	Uint8 _barHealthColor;
-	bool _autosave;
+	bool _autosave, _battleFinished;
 	int _numberOfDirectlyVisibleUnits, _numberOfEnemiesTotal, _numberOfEnemiesTotalPlusWounded;
 	Uint8 _indicatorTextColor, _indicatorGreen, _indicatorBlue, _indicatorPurple;
 	/// Popups a context sensitive list of actions the user can choose from.
@@ -226,8 +226,12 @@ public:
 	void handle(Action *action) override;
 	/// Displays a popup window.
 	void popup(State *state);
+	/// Throws away the pending popups.
+	void discardPopups();
 	/// Finishes a battle.
 	void finishBattle(bool abort, int inExitArea);
+	/// Has an autoplayed battle finished?
+	bool isBattleFinished() const { return _battleFinished; }
 	/// Show the launch button.
 	void showLaunchButton(bool show);
 	/// Show one of Psi, Special or Skill button
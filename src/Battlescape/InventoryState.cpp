@@ -54,6 +54,8 @@
 #include "../Engine/Options.h"
 #include "UnitInfoState.h"
 #include "BattlescapeState.h"
+#include "Map.h"
+#include "UnitSprite.h"
 #include "BattlescapeGenerator.h"
 #include "TileEngine.h"
 #include "../Mod/RuleInterface.h"
@@ -388,6 +390,10 @@ void InventoryState::init()
 		{
 			// Step 0: update unit's armor
 			unit->updateArmorFromSoldier(_game->getMod(), s, s->getArmor(), _battleGame->getDepth());
+			if (_parent)
+			{
+				_parent->getMap()->getUnitSpriteCache()->remove(unit);
+			}
 
 			// Step 1: remember the unit's equipment (excl. fixed items)
 			_clearInventoryTemplate(_tempInventoryTemplate);
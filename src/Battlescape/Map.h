@@ -40,6 +40,7 @@ class Timer;
 class Text;
 class Tile;
 class UnitSprite;
+class UnitSpriteCache;
 
 enum CursorType { CT_NONE, CT_NORMAL, CT_AIM, CT_PSI, CT_WAYPOINT, CT_THROW };
 enum TilePart : int;
@@ -101,6 +102,7 @@ private:
 	PathPreview _previewSetting;
 	Text *_txtAccuracy;
 	SurfaceSet *_projectileSet;
+	UnitSpriteCache *_unitSpriteCache;
 
 	void drawUnit(UnitSprite &unitSprite, Tile *unitTile, Tile *currTile, Position tileScreenPosition, bool topLayer, BattleUnit* movingUnit = nullptr);
 	void drawTerrain(Surface *surface);
@@ -164,6 +166,8 @@ public:
 
 	/// Gets the pointer to the camera.
 	Camera *getCamera();
+	/// Gets the units composed in previous frames.
+	UnitSpriteCache *getUnitSpriteCache();
 	/// Mouse-scrolls the camera.
 	void scrollMouse();
 	/// Keyboard-scrolls the camera.
@@ -25,6 +25,7 @@
 #include "../Mod/Armor.h"
 #include "../Savegame/BattleUnit.h"
 #include "../Engine/Options.h"
+#include "../Engine/Benchmark.h"
 #include "BattlescapeGame.h"
 #include "TileEngine.h"
 
@@ -82,6 +83,7 @@ PathfindingNode *Pathfinding::getNode(Position pos)
  */
 void Pathfinding::calculate(BattleUnit *unit, Position endPosition, BattleUnit *target, int maxTUCost)
 {
+	BenchmarkSectionScope benchmark(BENCHMARK_PATHFINDING);
 	_totalTUCost = 0;
 	_path.clear();
 	// i'm DONE with these out of bounds errors.
@@ -1146,6 +1148,7 @@ bool Pathfinding::bresenhamPath(Position origin, Position target, BattleUnit *ta
  */
 std::vector<int> Pathfinding::findReachable(BattleUnit *unit, const BattleActionCost &cost)
 {
+	BenchmarkSectionScope benchmark(BENCHMARK_PATHFINDING);
 	const Position start = unit->getPosition();
 	int tuMax = unit->getTimeUnits() - cost.Time;
 	int energyMax = unit->getEnergy() - cost.Energy;
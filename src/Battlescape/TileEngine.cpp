@@ -18,6 +18,7 @@
  */
 #include <assert.h>
 #include <climits>
+#include <algorithm>
 #include <set>
 #include "TileEngine.h"
 #include <SDL.h>
@@ -33,6 +34,7 @@
 #include "../Savegame/BattleUnitStatistics.h"
 #include "../Savegame/HitLog.h"
 #include "../Engine/RNG.h"
+#include "../Engine/Benchmark.h"
 #include "../Engine/GraphSubset.h"
 #include "BattlescapeState.h"
 #include "../Mod/MapDataSet.h"
@@ -210,6 +212,40 @@ MapSubset mapAreaExpand(MapSubset gs, int radius)
 	return { std::make_pair(gs.beg_x - radius, gs.end_x + radius), std::make_pair(gs.beg_y - radius, gs.end_y + radius) };
 }
 
+/**
+ * Direction of one explosion ray.
+ */
+struct ExplosionRay
+{
+	int te;
+	double cos_te, sin_te, sin_fi, cos_fi;
+};
+
+/**
+ * Gets the directions of all the rays cast by an explosion,
+ * in casting order: every 5 degrees vertically and every
+ * 3 degrees horizontally. Computed once, as every explosion
+ * casts the same rays.
+ * @return List of rays.
+ */
+const std::vector<ExplosionRay> &getExplosionRays()
+{
+	static const std::vector<ExplosionRay> rays = []
+	{
+		std::vector<ExplosionRay> r;
+		for (int fi = -90; fi <= 90; fi += 5)
+		{
+			// raytrace every 3 degrees makes sure we cover all tiles in a circle.
+			for (int te = 0; te <= 360; te += 3)
+			{
+				r.push_back({ te, cos(Deg2Rad(te)), sin(Deg2Rad(te)), sin(Deg2Rad(fi)), cos(Deg2Rad(fi)) });
+			}
+		}
+		return r;
+	}();
+	return rays;
+}
+
 } // namespace
 
 constexpr int TileEngine::heightFromCenter[11];
@@ -231,7 +267,7 @@ TileEngine::TileEngine(SavedBattleGame *save, Mod *mod) :
 	_maxViewDistance(mod->getMaxViewDistance()), _maxViewDistanceSq(_maxViewDistance * _maxViewDistance),
 	_maxVoxelViewDistance(_maxViewDistance * 16), _maxDarknessToSeeUnits(mod->getMaxDarknessToSeeUnits()),
 	_maxStaticLightDistance(mod->getMaxStaticLightDistance()), _maxDynamicLightDistance(mod->getMaxDynamicLightDistance()),
-	_enhancedLighting(mod->getEnhancedLighting())
+	_enhancedLighting(mod->getEnhancedLighting()), _explosionGeneration(0)
 {
 	_blockVisibility.resize(save->getMapSizeXYZ());
 	_cacheTilePos = invalid;
@@ -409,6 +445,7 @@ void TileEngine::calculateUnitLighting(MapSubset gs)
 
 void TileEngine::calculateLighting(LightLayers layer, Position position, int eventRadius, bool terrianChanged)
 {
+	BenchmarkSectionScope benchmark(BENCHMARK_LIGHTING);
 	auto gsDynamic = MapSubset{ _save->getMapSizeX(), _save->getMapSizeY() };
 	auto gsStatic = gsDynamic;
 
@@ -743,6 +780,7 @@ inline bool TileEngine::inEventVisibilitySector(const Position &toCheck) const
 */
 bool TileEngine::calculateUnitsInFOV(BattleUnit* unit, const Position eventPos, const int eventRadius)
 {
+	BenchmarkSectionScope benchmark(BENCHMARK_FOV);
 	size_t oldNumVisibleUnits = unit->getUnitsSpottedThisTurn().size();
 	bool useTurretDirection = false;
 	if (Options::strafe && (unit->getTurretType() > -1)) {
@@ -833,6 +871,7 @@ bool TileEngine::calculateUnitsInFOV(BattleUnit* unit, const Position eventPos,
 */
 void TileEngine::calculateTilesInFOV(BattleUnit *unit, const Position eventPos, const int eventRadius)
 {
+	BenchmarkSectionScope benchmark(BENCHMARK_FOV);
 	bool useTurretDirection = false;
 	bool skipNarrowArcTest = false;
 	int direction;
@@ -963,6 +1002,7 @@ void TileEngine::calculateTilesInFOV(BattleUnit *unit, const Position eventPos,
 */
 bool TileEngine::calculateFOV(BattleUnit *unit, bool doTileRecalc, bool doUnitRecalc)
 {
+	BenchmarkSectionScope benchmark(BENCHMARK_FOV);
 	//Force a full FOV recheck for this unit.
 	if (doTileRecalc) calculateTilesInFOV(unit);
 	return doUnitRecalc ? calculateUnitsInFOV(unit) : false;
@@ -1690,6 +1730,7 @@ bool TileEngine::canTargetTile(Position *originVoxel, Tile *tile, int part, Posi
  */
 void TileEngine::calculateFOV(Position position, int eventRadius, const bool updateTiles, const bool appendToTileVisibility)
 {
+	BenchmarkSectionScope benchmark(BENCHMARK_FOV);
 	int updateRadius;
 	if (eventRadius == -1)
 	{
@@ -1728,6 +1769,7 @@ void TileEngine::calculateFOV(Position position, int eventRadius, const bool upd
  */
 bool TileEngine::checkReactionFire(BattleUnit *unit, const BattleAction &originalAction)
 {
+	BenchmarkSectionScope benchmark(BENCHMARK_REACTION_FIRE);
 	// reaction fire only triggered when the actioning unit is of the currently playing side, and is still on the map (alive)
 	if (unit->getFaction() != _save->getSide() || unit->getTile() == 0)
 	{
@@ -1784,7 +1826,9 @@ std::vector<TileEngine::ReactionScore> TileEngine::getSpottingUnits(BattleUnit*
 	// no reaction on civilian turn.
 	if (_save->getSide() != FACTION_NEUTRAL)
 	{
-		for (std::vector<BattleUnit*>::const_iterator i = _save->getUnits()->begin(); i != _save->getUnits()->end(); ++i)
+		std::vector<BattleUnit*> candidates;
+		_save->getUnitsInRange(unit->getPosition(), getMaxViewDistance(), candidates);
+		for (std::vector<BattleUnit*>::const_iterator i = candidates.begin(); i != candidates.end(); ++i)
 		{
 				// not dead/unconscious
 			if (!(*i)->isOut() &&
@@ -2537,9 +2581,7 @@ void TileEngine::explode(BattleActionAttack attack, Position center, int power,
 	int hitSide = 0;
 	int diagonalWall = 0;
 	int power_;
-	std::map<Tile*, int> tilesAffected;
 	std::vector<BattleItem*> toRemove;
-	std::pair<std::map<Tile*, int>::iterator, bool> ret;
 
 	if (type->FireBlastCalc)
 	{
@@ -2561,7 +2603,8 @@ void TileEngine::explode(BattleActionAttack attack, Position center, int power,
 		vertdec = 0.5f * type->RadiusReduction;
 	}
 
-	Tile *origin = _save->getTile(Position(centetTile));
+	Tile *const centerTile = _save->getTile(Position(centetTile));
+	Tile *origin = centerTile;
 	Tile *dest = nullptr;
 	if (origin->isBigWall()) //pre-calculations for bigwall deflection
 	{
@@ -2572,131 +2615,149 @@ void TileEngine::explode(BattleActionAttack attack, Position center, int power,
 			hitSide = (center.x % 16 + center.y % 16 - 15) > 0 ? 1 : -1;
 	}
 
-	for (int fi = -90; fi <= 90; fi += 5)
+	// highest tile damage per affected tile, a tile is affected in this explosion when its stamp matches
+	const size_t mapSize = _save->getMapSizeXYZ();
+	if (_explosionStamp.size() != mapSize)
 	{
-		// raytrace every 3 degrees makes sure we cover all tiles in a circle.
-		for (int te = 0; te <= 360; te += 3)
-		{
-			double cos_te = cos(Deg2Rad(te));
-			double sin_te = sin(Deg2Rad(te));
-			double sin_fi = sin(Deg2Rad(fi));
-			double cos_fi = cos(Deg2Rad(fi));
+		_explosionStamp.assign(mapSize, 0);
+		_explosionDamage.assign(mapSize, 0);
+	}
+	if (++_explosionGeneration == 0)
+	{
+		std::fill(_explosionStamp.begin(), _explosionStamp.end(), 0);
+		_explosionGeneration = 1;
+	}
+	_explosionTiles.clear();
+
+	for (const auto &ray : getExplosionRays())
+	{
+		const int te = ray.te;
+		const double cos_te = ray.cos_te;
+		const double sin_te = ray.sin_te;
+		const double sin_fi = ray.sin_fi;
+		const double cos_fi = ray.cos_fi;
 
-			origin = _save->getTile(centetTile);
-			dest = origin;
-			double l = 0;
-			int tileX, tileY, tileZ;
-			power_ = power;
-			while (power_ > 0 && l <= maxRadius)
+		origin = centerTile;
+		dest = origin;
+		double l = 0;
+		int tileX, tileY, tileZ;
+		power_ = power;
+		while (power_ > 0 && l <= maxRadius)
+		{
+			if (power_ > 0)
 			{
-				if (power_ > 0)
+				const int index = _save->getTileIndex(dest->getPosition());
+				const bool firstHit = _explosionStamp[index] != _explosionGeneration; // check if we had this tile already affected
+				if (firstHit)
 				{
-					ret = tilesAffected.insert(std::make_pair(dest, 0)); // check if we had this tile already affected
+					_explosionStamp[index] = _explosionGeneration;
+					_explosionDamage[index] = 0;
+					_explosionTiles.push_back(dest);
+				}
 
-					const int tileDmg = type->getTileFinalDamage(power_);
-					if (tileDmg > ret.first->second)
-					{
-						ret.first->second = tileDmg;
-					}
-					if (ret.second)
-					{
-						const int damage = type->getRandomDamage(power_);
-						BattleUnit *bu = dest->getOverlappingUnit(_save);
+				const int tileDmg = type->getTileFinalDamage(power_);
+				if (tileDmg > _explosionDamage[index])
+				{
+					_explosionDamage[index] = tileDmg;
+				}
+				if (firstHit)
+				{
+					const int damage = type->getRandomDamage(power_);
+					BattleUnit *bu = dest->getOverlappingUnit(_save);
 
-						toRemove.clear();
-						if (bu)
+					toRemove.clear();
+					if (bu)
+					{
+						if (Position::distance2d(dest->getPosition(), centetTile) < 2)
 						{
-							if (Position::distance2d(dest->getPosition(), centetTile) < 2)
-							{
-								// ground zero effect is in effect
-								hitUnit(attack, bu, Position(0, 0, 0), damage, type, rangeAtack);
-							}
-							else
-							{
-								// directional damage relative to explosion position.
-								// units above the explosion will be hit in the legs, units lateral to or below will be hit in the torso
-								hitUnit(attack, bu, centetTile + Position(0, 0, 5) - dest->getPosition(), damage, type, rangeAtack);
-							}
+							// ground zero effect is in effect
+							hitUnit(attack, bu, Position(0, 0, 0), damage, type, rangeAtack);
+						}
+						else
+						{
+							// directional damage relative to explosion position.
+							// units above the explosion will be hit in the legs, units lateral to or below will be hit in the torso
+							hitUnit(attack, bu, centetTile + Position(0, 0, 5) - dest->getPosition(), damage, type, rangeAtack);
+						}
 
-							// Affect all items and units in inventory
-							const int itemDamage = bu->getOverKillDamage();
-							if (itemDamage > 0)
+						// Affect all items and units in inventory
+						const int itemDamage = bu->getOverKillDamage();
+						if (itemDamage > 0)
+						{
+							for (std::vector<BattleItem*>::iterator it = bu->getInventory()->begin(); it != bu->getInventory()->end(); ++it)
 							{
-								for (std::vector<BattleItem*>::iterator it = bu->getInventory()->begin(); it != bu->getInventory()->end(); ++it)
+								if (!hitUnit(attack, (*it)->getUnit(), Position(0, 0, 0), itemDamage, type, rangeAtack) && type->getItemFinalDamage(itemDamage) > (*it)->getRules()->getArmor())
 								{
-									if (!hitUnit(attack, (*it)->getUnit(), Position(0, 0, 0), itemDamage, type, rangeAtack) && type->getItemFinalDamage(itemDamage) > (*it)->getRules()->getArmor())
-									{
-										toRemove.push_back(*it);
-									}
+									toRemove.push_back(*it);
 								}
 							}
 						}
-						// Affect all items and units on ground
-						for (std::vector<BattleItem*>::iterator it = dest->getInventory()->begin(); it != dest->getInventory()->end(); ++it)
-						{
-							if (!hitUnit(attack, (*it)->getUnit(), Position(0, 0, 0), damage, type) && type->getItemFinalDamage(damage) > (*it)->getRules()->getArmor())
-							{
-								toRemove.push_back(*it);
-							}
-						}
-						for (std::vector<BattleItem*>::iterator it = toRemove.begin(); it != toRemove.end(); ++it)
+					}
+					// Affect all items and units on ground
+					for (std::vector<BattleItem*>::iterator it = dest->getInventory()->begin(); it != dest->getInventory()->end(); ++it)
+					{
+						if (!hitUnit(attack, (*it)->getUnit(), Position(0, 0, 0), damage, type) && type->getItemFinalDamage(damage) > (*it)->getRules()->getArmor())
 						{
-							_save->removeItem((*it));
+							toRemove.push_back(*it);
 						}
-
-						hitTile(dest, damage, type);
 					}
+					for (std::vector<BattleItem*>::iterator it = toRemove.begin(); it != toRemove.end(); ++it)
+					{
+						_save->removeItem((*it));
+					}
+
+					hitTile(dest, damage, type);
 				}
+			}
 
-				l += 1.0;
+			l += 1.0;
 
-				tileX = int(floor(centetTile.x + 0.5 + l * sin_te * cos_fi));
-				tileY = int(floor(centetTile.y + 0.5 + l * cos_te * cos_fi));
-				tileZ = int(floor(centetTile.z + 0.5 + l * sin_fi));
+			tileX = int(floor(centetTile.x + 0.5 + l * sin_te * cos_fi));
+			tileY = int(floor(centetTile.y + 0.5 + l * cos_te * cos_fi));
+			tileZ = int(floor(centetTile.z + 0.5 + l * sin_fi));
 
-				origin = dest;
-				dest = _save->getTile(Position(tileX, tileY, tileZ));
+			origin = dest;
+			dest = _save->getTile(Position(tileX, tileY, tileZ));
 
-				if (!dest) break; // out of map!
+			if (!dest) break; // out of map!
 
-				// blockage by terrain is deducted from the explosion power
-				power_ -= type->RadiusReduction; // explosive damage decreases by 10 per tile
-				if (origin->getPosition().z != tileZ)
-					power_ -= vertdec; //3d explosion factor
+			// blockage by terrain is deducted from the explosion power
+			power_ -= type->RadiusReduction; // explosive damage decreases by 10 per tile
+			if (origin->getPosition().z != tileZ)
+				power_ -= vertdec; //3d explosion factor
 
-				if (type->FireBlastCalc)
+			if (type->FireBlastCalc)
+			{
+				int dir;
+				Pathfinding::vectorToDirection(origin->getPosition() - dest->getPosition(), dir);
+				if (dir != -1 && dir %2) power_ -= 0.5f * type->RadiusReduction; // diagonal movement costs an extra 50% for fire.
+			}
+			if (l > 0.5) {
+				if ( l > 1.5)
 				{
-					int dir;
-					Pathfinding::vectorToDirection(origin->getPosition() - dest->getPosition(), dir);
-					if (dir != -1 && dir %2) power_ -= 0.5f * type->RadiusReduction; // diagonal movement costs an extra 50% for fire.
+					power_ -= verticalBlockage(origin, dest, type->ResistType, false) * 2;
+					power_ -= horizontalBlockage(origin, dest, type->ResistType, false) * 2;
 				}
-				if (l > 0.5) {
-					if ( l > 1.5)
+				else //tricky bigwall deflection /Volutar
+				{
+					bool skipObject = diagonalWall == 0;
+					if (diagonalWall == Pathfinding::BIGWALLNESW) // --
 					{
-						power_ -= verticalBlockage(origin, dest, type->ResistType, false) * 2;
-						power_ -= horizontalBlockage(origin, dest, type->ResistType, false) * 2;
+						if (hitSide<0 && te >= 135 && te < 315)
+							skipObject = true;
+						if (hitSide>0 && ( te < 135 || te > 315))
+							skipObject = true;
 					}
-					else //tricky bigwall deflection /Volutar
+					if (diagonalWall == Pathfinding::BIGWALLNWSE) // |
 					{
-						bool skipObject = diagonalWall == 0;
-						if (diagonalWall == Pathfinding::BIGWALLNESW) // --
-						{
-							if (hitSide<0 && te >= 135 && te < 315)
-								skipObject = true;
-							if (hitSide>0 && ( te < 135 || te > 315))
-								skipObject = true;
-						}
-						if (diagonalWall == Pathfinding::BIGWALLNWSE) // |
-						{
-							if (hitSide>0 && te >= 45 && te < 225)
-								skipObject = true;
-							if (hitSide<0 && ( te < 45 || te > 225))
-								skipObject = true;
-						}
-						power_ -= verticalBlockage(origin, dest, type->ResistType, skipObject) * 2;
-						power_ -= horizontalBlockage(origin, dest, type->ResistType, skipObject) * 2;
-
+						if (hitSide>0 && te >= 45 && te < 225)
+							skipObject = true;
+						if (hitSide<0 && ( te < 45 || te > 225))
+							skipObject = true;
 					}
+					power_ -= verticalBlockage(origin, dest, type->ResistType, skipObject) * 2;
+					power_ -= horizontalBlockage(origin, dest, type->ResistType, skipObject) * 2;
+
 				}
 			}
 		}
@@ -2705,14 +2766,16 @@ void TileEngine::explode(BattleActionAttack attack, Position center, int power,
 	// now detonate the tiles affected by explosion
 	if (type->ToTile > 0.0f)
 	{
-		for (std::map<Tile*, int>::iterator i = tilesAffected.begin(); i != tilesAffected.end(); ++i)
+		// tiles are stored in map order, keep detonating them in that order
+		std::sort(_explosionTiles.begin(), _explosionTiles.end());
+		for (Tile *tile : _explosionTiles)
 		{
-			if (detonate(i->first, i->second))
+			if (detonate(tile, _explosionDamage[_save->getTileIndex(tile->getPosition())]))
 			{
 				_save->addDestroyedObjective();
 			}
-			applyGravity(i->first);
-			Tile *j = _save->getTile(i->first->getPosition() + Position(0,0,1));
+			applyGravity(tile);
+			Tile *j = _save->getTile(tile->getPosition() + Position(0,0,1));
 			if (j)
 				applyGravity(j);
 		}
@@ -4799,6 +4862,7 @@ bool TileEngine::validateThrow(BattleAction &action, Position originVoxel, Posit
  */
 void TileEngine::recalculateFOV()
 {
+	BenchmarkSectionScope benchmark(BENCHMARK_FOV);
 	for (std::vector<BattleUnit*>::iterator bu = _save->getUnits()->begin(); bu != _save->getUnits()->end(); ++bu)
 	{
 		if ((*bu)->getTile() != 0)
@@ -108,6 +108,10 @@ private:
 	const int _maxDynamicLightDistance;
 	const int _enhancedLighting;
 	Position _eventVisibilitySectorL, _eventVisibilitySectorR, _eventVisibilityObserverPos;
+	std::vector<int> _explosionDamage;
+	std::vector<Uint32> _explosionStamp;
+	std::vector<Tile*> _explosionTiles;
+	Uint32 _explosionGeneration;
 	std::vector<BattleUnit*> _movingUnitPrev;
 	BattleUnit* _movingUnit = nullptr;
 
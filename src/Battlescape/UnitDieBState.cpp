@@ -21,6 +21,7 @@
 #include "TileEngine.h"
 #include "BattlescapeState.h"
 #include "Map.h"
+#include "UnitSprite.h"
 #include "../Engine/Game.h"
 #include "../Savegame/BattleItem.h"
 #include "../Savegame/BattleUnit.h"
@@ -199,6 +200,8 @@ void UnitDieBState::think()
 	else if (_unit->isOut())
 	{
 		_extraFrame = 1;
+		// from now on the unit is drawn as an item
+		_parent->getMap()->getUnitSpriteCache()->remove(_unit);
 		if (!_noSound && !_damageType->isDirect() && _unit->getStatus() != STATUS_UNCONSCIOUS)
 		{
 			playDeathSound();
@@ -287,6 +290,7 @@ void UnitDieBState::convertUnitToCorpse()
 				{
 					auto corpseRules = _unit->getArmor()->getCorpseBattlescape()[0]; // we're in an inventory, so we must be a 1x1 unit
 					(*it)->convertToCorpse(corpseRules);
+					_parent->getSave()->invalidateAttractiveItems();
 					break;
 				}
 				++it;
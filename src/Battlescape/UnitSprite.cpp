@@ -17,6 +17,8 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "UnitSprite.h"
+#include <algorithm>
+#include <climits>
 #include "../Engine/SurfaceSet.h"
 #include "../Mod/RuleItem.h"
 #include "../Mod/Armor.h"
@@ -33,15 +35,53 @@
 namespace OpenXcom
 {
 
+/**
+ * Creates an empty cache of composed units.
+ */
+UnitSpriteCache::UnitSpriteCache()
+{
+
+}
+
+/**
+ * Deletes the composed units.
+ */
+UnitSpriteCache::~UnitSpriteCache()
+{
+
+}
+
+/**
+ * Forgets all composed units, eg. when the graphics they
+ * were made from are not valid anymore.
+ */
+void UnitSpriteCache::clear()
+{
+	_entries.clear();
+}
+
+/**
+ * Forgets the composed parts of a unit, eg. when it dies
+ * or changes armor.
+ * @param unit Pointer to the unit.
+ */
+void UnitSpriteCache::remove(const BattleUnit *unit)
+{
+	auto begin = _entries.lower_bound(std::make_pair(unit, INT_MIN));
+	auto end = _entries.upper_bound(std::make_pair(unit, INT_MAX));
+	_entries.erase(begin, end);
+}
+
 /**
  * Sets up a UnitSprite with the specified size and position.
  * @param width Width in pixels.
  * @param height Height in pixels.
  * @param x X position in pixels.
  * @param y Y position in pixels.
+ * @param cache Composed units from previous frames, can be null.
  */
-UnitSprite::UnitSprite(Surface* dest, Mod* mod, int frame, bool helmet) :
-	_unit(0), _itemR(0), _itemL(0),
+UnitSprite::UnitSprite(Surface* dest, Mod* mod, int frame, bool helmet, UnitSpriteCache* cache) :
+	_unit(0), _itemR(0), _itemL(0), _cache(cache), _composing(false), _composeAnimFrame(false), _composeBurn(false),
 	_unitSurface(0),
 	_itemSurface(mod->getSurfaceSet("HANDOB.PCK")),
 	_fireSurface(mod->getSurfaceSet("SMOKE.PCK")),
@@ -72,6 +112,12 @@ namespace
  */
 const int InvalidSpriteIndex = -256;
 
+/**
+ * Positions of recolor script arguments, after the new and old pixel.
+ */
+const int RecolorArgAnimFrame = 4;
+const int RecolorArgBurn = 6;
+
 /**
  * Get item if can be visible on sprite.
  */
@@ -146,13 +192,10 @@ void UnitSprite::blitItem(Part& item)
 		return;
 	}
 	ScriptWorkerBlit work;
-	BattleItem::ScriptFill(&work, (item.bodyPart == BODYPART_ITEM_RIGHTHAND ? _itemR : _itemL), item.bodyPart, _animationFrame, _shade);
-
-	_dest->lock();
+	BattleItem *it = (item.bodyPart == BODYPART_ITEM_RIGHTHAND ? _itemR : _itemL);
+	fillScript(work, item.bodyPart, it);
 
-	work.executeBlit(item.src, _dest,  _x + item.offX, _y + item.offY, _shade, _mask);
-
-	_dest->unlock();
+	blitPart(work, item, it);
 }
 
 /**
@@ -166,11 +209,142 @@ void UnitSprite::blitBody(Part& body)
 		return;
 	}
 	ScriptWorkerBlit work;
-	BattleUnit::ScriptFill(&work, _unit, body.bodyPart, _animationFrame, _shade, _burn);
+	fillScript(work, body.bodyPart, nullptr);
+
+	blitPart(work, body, nullptr);
+}
+
+/**
+ * Sets up the recolor script of an item, or of the unit itself.
+ * @param work Script worker to set up.
+ * @param bodyPart Part of the unit the sprite is for.
+ * @param item Item on the sprite, null for the unit.
+ */
+void UnitSprite::fillScript(ScriptWorkerBlit& work, int bodyPart, BattleItem *item)
+{
+	if (item)
+	{
+		BattleItem::ScriptFill(&work, item, bodyPart, _animationFrame, _shade);
+	}
+	else
+	{
+		BattleUnit::ScriptFill(&work, _unit, bodyPart, _animationFrame, _shade, _burn);
+	}
+}
+
+/**
+ * Blits a sprite onto the surface, or keeps it to compose the unit
+ * in one go. Recolor scripts that read objects or use the background
+ * pixel can't be composed in advance, so once a part has one of those
+ * the rest of the unit is drawn directly.
+ * @param work Script worker of the part.
+ * @param part Sprite to blit.
+ * @param item Item on the sprite, null for the unit.
+ */
+void UnitSprite::blitPart(ScriptWorkerBlit& work, const Part& part, BattleItem *item)
+{
+	if (_composing)
+	{
+		if (!work.haveScript() || work.canReuseBlit())
+		{
+			_composeAnimFrame |= work.isArgNamed(RecolorArgAnimFrame);
+			_composeBurn |= work.isArgNamed(RecolorArgBurn);
+			_layers.push_back(UnitSpriteCache::Layer{ part.src, part.offX, part.offY, part.bodyPart, item });
+			return;
+		}
+		blitLayers();
+		_composing = false;
+	}
+
+	_dest->lock();
+
+	work.executeBlit(part.src, _dest,  _x + part.offX, _y + part.offY, _shade, _mask);
+
+	_dest->unlock();
+}
+
+/**
+ * Blits the sprites kept for composing one by one.
+ */
+void UnitSprite::blitLayers()
+{
+	ScriptWorkerBlit work;
+
+	_dest->lock();
+
+	for (const auto& l : _layers)
+	{
+		fillScript(work, l.bodyPart, l.item);
+		work.executeBlit(l.src, _dest,  _x + l.offX, _y + l.offY, _shade, _mask);
+	}
+
+	_dest->unlock();
+
+	_layers.clear();
+}
+
+/**
+ * Blits the sprites kept for composing as one sprite, shaded and
+ * recolored when composed. The composed sprite is reused as long as
+ * the unit is made of the same sprites with the same shade, and
+ * the same animation frame and burn if the scripts use them, which is
+ * the case for most units most of the time.
+ */
+void UnitSprite::blitComposed()
+{
+	if (_layers.size() < 2)
+	{
+		blitLayers();
+		return;
+	}
+
+	const int animFrame = _composeAnimFrame ? _animationFrame : 0;
+	const int burn = _composeBurn ? _burn : 0;
+	auto& entry = _cache->_entries[std::make_pair((const BattleUnit*)_unit, _part)];
+	if (!entry.surface || entry.shade != _shade || entry.animFrame != animFrame || entry.burn != burn || entry.layers != _layers)
+	{
+		int x1 = INT_MAX, y1 = INT_MAX, x2 = INT_MIN, y2 = INT_MIN;
+		for (const auto& l : _layers)
+		{
+			x1 = std::min(x1, l.offX);
+			y1 = std::min(y1, l.offY);
+			x2 = std::max(x2, l.offX + l.src->getWidth());
+			y2 = std::max(y2, l.offY + l.src->getHeight());
+		}
+		if (!entry.surface || entry.surface->getWidth() != x2 - x1 || entry.surface->getHeight() != y2 - y1)
+		{
+			entry.surface = std::make_unique<Surface>(x2 - x1, y2 - y1);
+		}
+		else
+		{
+			entry.surface->clear();
+		}
+
+		// shading a non-transparent pixel by a positive amount never makes it
+		// transparent, so the composed sprite can be blitted again without shade.
+		ScriptWorkerBlit work;
+		entry.surface->lock();
+		for (const auto& l : _layers)
+		{
+			fillScript(work, l.bodyPart, l.item);
+			work.executeBlit(l.src, entry.surface.get(), l.offX - x1, l.offY - y1, _shade);
+		}
+		entry.surface->unlock();
+
+		entry.layers.swap(_layers);
+		entry.shade = _shade;
+		entry.animFrame = animFrame;
+		entry.burn = burn;
+		entry.x = x1;
+		entry.y = y1;
+	}
+	_layers.clear();
+
+	ScriptWorkerBlit work;
 
 	_dest->lock();
 
-	work.executeBlit(body.src, _dest,  _x + body.offX, _y + body.offY, _shade, _mask);
+	work.executeBlit(entry.surface.get(), _dest,  _x + entry.x, _y + entry.y, 0, _mask);
 
 	_dest->unlock();
 }
@@ -245,7 +419,16 @@ void UnitSprite::draw(BattleUnit* unit, int part, int x, int y, int shade, Graph
 		&UnitSprite::drawRoutine3,
 	};
 	// Call the matching routine
+	_layers.clear();
+	_composing = _cache != nullptr && _shade >= 0;
+	_composeAnimFrame = false;
+	_composeBurn = false;
 	(this->*(routines[_drawingRoutine]))();
+	if (_composing)
+	{
+		blitComposed();
+		_composing = false;
+	}
 	// draw fire
 	if (unit->getFire() > 0)
 	{
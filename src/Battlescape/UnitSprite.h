@@ -17,6 +17,9 @@
  * You should have received a copy of the GNU General Public License
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <map>
+#include <memory>
+#include <vector>
 #include "../Engine/Surface.h"
 #include "../Engine/Script.h"
 
@@ -28,6 +31,53 @@ class BattleItem;
 class SurfaceSet;
 class Mod;
 
+/**
+ * Units composed by UnitSprite in previous frames.
+ * A unit that is drawn from the same sprites, at the same offsets
+ * and with the same shade as last time is drawn with a single blit.
+ * Only sprites with pure recolor scripts are composed, since those
+ * give the same colors for the same arguments, whatever the state
+ * of the unit. The parts of a unit are removed when it dies or
+ * changes armor.
+ */
+class UnitSpriteCache
+{
+	friend class UnitSprite;
+
+	/// One sprite blitted when composing a unit.
+	struct Layer
+	{
+		Surface *src;
+		int offX, offY;
+		int bodyPart;
+		BattleItem *item;
+
+		bool operator==(const Layer &other) const { return src == other.src && offX == other.offX && offY == other.offY && bodyPart == other.bodyPart && item == other.item; }
+		bool operator!=(const Layer &other) const { return !(*this == other); }
+	};
+	/// Composed sprite of one part of a unit.
+	struct Entry
+	{
+		std::vector<Layer> layers;
+		int shade = 0;
+		int animFrame = 0;
+		int burn = 0;
+		int x = 0, y = 0;
+		std::unique_ptr<Surface> surface;
+	};
+
+	std::map<std::pair<const BattleUnit*, int>, Entry> _entries;
+public:
+	/// Creates an empty cache.
+	UnitSpriteCache();
+	/// Cleans up the cache.
+	~UnitSpriteCache();
+	/// Forgets all composed units.
+	void clear();
+	/// Forgets the composed parts of a unit.
+	void remove(const BattleUnit *unit);
+};
+
 /**
  * A class that renders a specific unit, given its render rules
  * combining the right frames from the surfaceset.
@@ -50,6 +100,9 @@ private:
 
 	BattleUnit *_unit;
 	BattleItem *_itemR, *_itemL;
+	UnitSpriteCache *_cache;
+	std::vector<UnitSpriteCache::Layer> _layers;
+	bool _composing, _composeAnimFrame, _composeBurn;
 	SurfaceSet *_unitSurface, *_itemSurface, *_fireSurface, *_breathSurface, *_facingArrowSurface;
 	Surface *_dest;
 	Mod *_mod;
@@ -104,9 +157,17 @@ private:
 	void blitItem(Part& item);
 	/// Blit body sprite.
 	void blitBody(Part& body);
+	/// Set up recolor script of a sprite.
+	void fillScript(ScriptWorkerBlit& work, int bodyPart, BattleItem *item);
+	/// Blit or keep a sprite for composing.
+	void blitPart(ScriptWorkerBlit& work, const Part& part, BattleItem *item);
+	/// Blit the sprites kept so far.
+	void blitLayers();
+	/// Blit the sprites kept so far as one composed sprite.
+	void blitComposed();
 public:
 	/// Creates a new UnitSprite at the specified position and size.
-	UnitSprite(Surface* dest, Mod* mod, int frame, bool helmet);
+	UnitSprite(Surface* dest, Mod* mod, int frame, bool helmet, UnitSpriteCache* cache = nullptr);
 	/// Cleans up the UnitSprite.
 	~UnitSprite();
 	/// Draws the unit.
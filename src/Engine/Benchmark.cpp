@@ -0,0 +1,212 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "Benchmark.h"
+#include <iomanip>
+#include <sstream>
+#include "Logger.h"
+
+#ifdef BENCHMARK_ALLOCATIONS
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+std::atomic<uint64_t> allocationCount(0);
+}
+
+/*
+ * Counting replacements of the global allocation functions.
+ * The array and nothrow forms fall back on these by default.
+ */
+void *operator new(std::size_t size)
+{
+	++allocationCount;
+	if (size == 0)
+		size = 1;
+	while (true)
+	{
+		void *p = std::malloc(size);
+		if (p)
+			return p;
+		std::new_handler handler = std::get_new_handler();
+		if (!handler)
+			throw std::bad_alloc();
+		handler();
+	}
+}
+
+void operator delete(void *p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+	std::free(p);
+}
+#endif
+
+namespace OpenXcom
+{
+
+/**
+ * Starts measuring a piece of code.
+ * @param counter Counter to update when done.
+ */
+BenchmarkScope::BenchmarkScope(BenchmarkCounter &counter) : _counter(counter), _start(std::chrono::steady_clock::now()), _allocations(Benchmark::getAllocations())
+{
+}
+
+/**
+ * Adds the time and allocations spent since
+ * construction to the counter.
+ */
+BenchmarkScope::~BenchmarkScope()
+{
+	auto elapsed = std::chrono::steady_clock::now() - _start;
+	_counter.calls++;
+	_counter.nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+	_counter.allocations += Benchmark::getAllocations() - _allocations;
+}
+
+namespace Benchmark
+{
+
+bool sectionsEnabled = false;
+
+namespace
+{
+std::vector<BenchmarkCounter> sections = { BenchmarkCounter("pathfinding"), BenchmarkCounter("FOV"), BenchmarkCounter("lighting"), BenchmarkCounter("reaction fire"), BenchmarkCounter("scripts"), BenchmarkCounter("globe"), BenchmarkCounter("globe land"), BenchmarkCounter("globe shadow"), BenchmarkCounter("globe radars") };
+int sectionDepth[BENCHMARK_SECTIONS] = { };
+std::chrono::steady_clock::time_point sectionStart[BENCHMARK_SECTIONS];
+uint64_t sectionAllocations[BENCHMARK_SECTIONS] = { };
+}
+
+/**
+ * Starts or stops timing the engine sections.
+ * Starting resets the counters.
+ * @param enable Time the sections?
+ */
+void enableSections(bool enable)
+{
+	if (enable && !sectionsEnabled)
+	{
+		for (auto &c : sections)
+		{
+			c = BenchmarkCounter(c.name);
+		}
+	}
+	sectionsEnabled = enable;
+}
+
+/**
+ * Gets the time and allocations spent in every
+ * engine section since they were enabled.
+ * @return List of counters, indexed by BenchmarkSection.
+ */
+const std::vector<BenchmarkCounter> &getSections()
+{
+	return sections;
+}
+
+/**
+ * Starts the clock of a section, unless it is already running.
+ * @param section Engine section.
+ */
+void enterSection(BenchmarkSection section)
+{
+	if (sectionDepth[section]++ == 0)
+	{
+		sectionAllocations[section] = getAllocations();
+		sectionStart[section] = std::chrono::steady_clock::now();
+	}
+}
+
+/**
+ * Stops the clock of a section when leaving the outermost use.
+ * @param section Engine section.
+ */
+void leaveSection(BenchmarkSection section)
+{
+	if (--sectionDepth[section] == 0)
+	{
+		auto elapsed = std::chrono::steady_clock::now() - sectionStart[section];
+		BenchmarkCounter &c = sections[section];
+		c.calls++;
+		c.nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+		c.allocations += getAllocations() - sectionAllocations[section];
+	}
+}
+
+/**
+ * Checks if heap allocations are counted, which needs
+ * the BENCHMARK_ALLOCATIONS build option.
+ * @return True if allocations are counted.
+ */
+bool countsAllocations()
+{
+#ifdef BENCHMARK_ALLOCATIONS
+	return true;
+#else
+	return false;
+#endif
+}
+
+/**
+ * Returns the number of heap allocations since the program started.
+ * @return Number of allocations, always 0 if they aren't counted.
+ */
+uint64_t getAllocations()
+{
+#ifdef BENCHMARK_ALLOCATIONS
+	return allocationCount.load(std::memory_order_relaxed);
+#else
+	return 0;
+#endif
+}
+
+/**
+ * Writes the calls, time and allocations of each counter to the log.
+ * @param title Title of the table.
+ * @param counters List of counters.
+ */
+void report(const std::string &title, const std::vector<BenchmarkCounter> &counters)
+{
+	Log(LOG_INFO) << title;
+	std::ostringstream header;
+	header << std::left << std::setw(20) << "section" << std::right << std::setw(12) << "calls" << std::setw(14) << "total ms" << std::setw(14) << "avg us" << std::setw(14) << "allocations";
+	Log(LOG_INFO) << header.str();
+	for (const auto &c : counters)
+	{
+		std::ostringstream line;
+		line << std::left << std::setw(20) << c.name << std::right << std::setw(12) << c.calls;
+		line << std::fixed << std::setprecision(3) << std::setw(14) << c.nanoseconds / 1e6;
+		line << std::setw(14) << (c.calls ? c.nanoseconds / 1e3 / c.calls : 0.0);
+		if (countsAllocations())
+			line << std::setw(14) << c.allocations;
+		else
+			line << std::setw(14) << "n/a";
+		Log(LOG_INFO) << line.str();
+	}
+}
+
+}
+
+}
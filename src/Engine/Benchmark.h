@@ -0,0 +1,113 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace OpenXcom
+{
+
+/**
+ * Accumulated cost of one measured part of the game logic.
+ */
+struct BenchmarkCounter
+{
+	std::string name;
+	uint64_t calls = 0;
+	uint64_t nanoseconds = 0;
+	uint64_t allocations = 0;
+
+	BenchmarkCounter(const std::string &n) : name(n) { }
+};
+
+/**
+ * Measures the time and heap allocations spent
+ * during its lifetime and adds them to a counter.
+ */
+class BenchmarkScope
+{
+private:
+	BenchmarkCounter &_counter;
+	std::chrono::steady_clock::time_point _start;
+	uint64_t _allocations;
+public:
+	/// Starts measuring.
+	BenchmarkScope(BenchmarkCounter &counter);
+	/// Stops measuring and updates the counter.
+	~BenchmarkScope();
+	BenchmarkScope(const BenchmarkScope&) = delete;
+	BenchmarkScope &operator=(const BenchmarkScope&) = delete;
+};
+
+/**
+ * Parts of the engine that time themselves while a benchmark
+ * is running or section timing is turned on in debug mode.
+ */
+enum BenchmarkSection { BENCHMARK_PATHFINDING, BENCHMARK_FOV, BENCHMARK_LIGHTING, BENCHMARK_REACTION_FIRE, BENCHMARK_SCRIPTS, BENCHMARK_GLOBE, BENCHMARK_GLOBE_LAND, BENCHMARK_GLOBE_SHADOW, BENCHMARK_GLOBE_RADARS, BENCHMARK_SECTIONS };
+
+namespace Benchmark
+{
+	/// Are the engine sections being timed?
+	extern bool sectionsEnabled;
+	/// Starts or stops timing the engine sections.
+	void enableSections(bool enable);
+	/// Gets the counters of the engine sections.
+	const std::vector<BenchmarkCounter> &getSections();
+	/// Marks the start of an engine section.
+	void enterSection(BenchmarkSection section);
+	/// Marks the end of an engine section.
+	void leaveSection(BenchmarkSection section);
+	/// Checks if this build counts heap allocations.
+	bool countsAllocations();
+	/// Gets the number of heap allocations done so far.
+	uint64_t getAllocations();
+	/// Writes a table of counters to the log.
+	void report(const std::string &title, const std::vector<BenchmarkCounter> &counters);
+}
+
+/**
+ * Times an engine section for its lifetime. Costs a single
+ * check when no benchmark is running. Recursive or nested
+ * uses of the same section are only counted once.
+ */
+class BenchmarkSectionScope
+{
+private:
+	BenchmarkSection _section;
+	bool _active;
+public:
+	/// Enters the section.
+	BenchmarkSectionScope(BenchmarkSection section) : _section(section), _active(Benchmark::sectionsEnabled)
+	{
+		if (_active)
+			Benchmark::enterSection(_section);
+	}
+	/// Leaves the section.
+	~BenchmarkSectionScope()
+	{
+		if (_active)
+			Benchmark::leaveSection(_section);
+	}
+	BenchmarkSectionScope(const BenchmarkSectionScope&) = delete;
+	BenchmarkSectionScope &operator=(const BenchmarkSectionScope&) = delete;
+};
+
+}
@@ -0,0 +1,477 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "BlitKernels.h"
+#include <array>
+#include <string>
+#include <vector>
+#include "Benchmark.h"
+#include "Logger.h"
+#include "ShaderDraw.h"
+#include "Zoom.h"
+
+#if (_MSC_VER >= 1400) || (defined(__MINGW32__) && defined(__SSE2__))
+
+#ifndef __SSE2__
+#define __SSE2__ true
+#endif
+// probably Visual Studio (or Intel C++ which should also work)
+#include <intrin.h>
+#endif
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// AVX2 code is built for every x86 target and only called after checking the CPU
+#if defined(__GNUC__) && (__i386__ || __x86_64__)
+#define BLIT_KERNELS_AVX2
+#define BLIT_KERNELS_AVX2_TARGET __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#define BLIT_KERNELS_AVX2
+#define BLIT_KERNELS_AVX2_TARGET
+#include <immintrin.h>
+#endif
+
+namespace OpenXcom
+{
+
+namespace BlitKernels
+{
+
+namespace
+{
+
+typedef void (*ShadeRowFunc)(Uint8 *dest, const Uint8 *src, int count, int shade);
+typedef void (*ReplaceRowFunc)(Uint8 *dest, const Uint8 *src, int count, int shade, int newColor);
+
+/// Number of shades with a precomputed table.
+const int SHADE_TABLES = 16;
+
+/**
+ * Pixels given by helper::StandardShade for every source pixel
+ * and the shades blits use, indexed by shade then pixel.
+ */
+const std::array<std::array<Uint8, 256>, SHADE_TABLES> shadeTables = []
+{
+	std::array<std::array<Uint8, 256>, SHADE_TABLES> tables;
+	for (int shade = 0; shade < SHADE_TABLES; ++shade)
+	{
+		for (int pixel = 0; pixel < 256; ++pixel)
+		{
+			Uint8 dest = 0;
+			helper::StandardShade::func(dest, (Uint8)pixel, shade);
+			tables[shade][pixel] = dest;
+		}
+	}
+	return tables;
+}();
+
+void shadeRowScalar(Uint8 *dest, const Uint8 *src, int count, int shade)
+{
+	if (shade >= 0 && shade < SHADE_TABLES)
+	{
+		const Uint8 *table = shadeTables[shade].data();
+		for (int i = 0; i < count; ++i)
+		{
+			if (src[i])
+			{
+				dest[i] = table[src[i]];
+			}
+		}
+		return;
+	}
+	for (int i = 0; i < count; ++i)
+	{
+		helper::StandardShade::func(dest[i], src[i], shade);
+	}
+}
+
+void replaceRowScalar(Uint8 *dest, const Uint8 *src, int count, int shade, int newColor)
+{
+	for (int i = 0; i < count; ++i)
+	{
+		helper::ColorReplace::func(dest[i], src[i], shade, newColor);
+	}
+}
+
+#ifdef __SSE2__
+/*
+ * Same as helper::StandardShade, 16 pixels at a time: shading wraps in 8 bits,
+ * pixels that would change color group become black, transparent ones are left alone.
+ */
+void shadeRowSSE2(Uint8 *dest, const Uint8 *src, int count, int shade)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i group = _mm_set1_epi8((char)helper::ColorGroup);
+	const __m128i black = _mm_set1_epi8((char)helper::ColorShade);
+	const __m128i add = _mm_set1_epi8((char)shade);
+	int i = 0;
+	for (; i + 16 <= count; i += 16)
+	{
+		__m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+		__m128i d = _mm_loadu_si128((const __m128i*)(dest + i));
+		__m128i n = s;
+		if (shade)
+		{
+			n = _mm_add_epi8(s, add);
+			__m128i sameGroup = _mm_cmpeq_epi8(_mm_and_si128(_mm_xor_si128(n, s), group), zero);
+			n = _mm_or_si128(_mm_and_si128(sameGroup, n), _mm_andnot_si128(sameGroup, black));
+		}
+		__m128i transparent = _mm_cmpeq_epi8(s, zero);
+		d = _mm_or_si128(_mm_and_si128(transparent, d), _mm_andnot_si128(transparent, n));
+		_mm_storeu_si128((__m128i*)(dest + i), d);
+	}
+	shadeRowScalar(dest + i, src + i, count - i, shade);
+}
+
+/*
+ * Same as helper::ColorReplace, 16 pixels at a time.
+ */
+void replaceRowSSE2(Uint8 *dest, const Uint8 *src, int count, int shade, int newColor)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i group = _mm_set1_epi8((char)helper::ColorGroup);
+	const __m128i black = _mm_set1_epi8((char)helper::ColorShade);
+	const __m128i add = _mm_set1_epi8((char)shade);
+	const __m128i color = _mm_set1_epi8((char)newColor);
+	int i = 0;
+	for (; i + 16 <= count; i += 16)
+	{
+		__m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+		__m128i d = _mm_loadu_si128((const __m128i*)(dest + i));
+		__m128i n = _mm_add_epi8(_mm_and_si128(s, black), add);
+		__m128i sameGroup = _mm_cmpeq_epi8(_mm_and_si128(n, group), zero);
+		n = _mm_or_si128(_mm_and_si128(sameGroup, _mm_or_si128(color, n)), _mm_andnot_si128(sameGroup, black));
+		__m128i transparent = _mm_cmpeq_epi8(s, zero);
+		d = _mm_or_si128(_mm_and_si128(transparent, d), _mm_andnot_si128(transparent, n));
+		_mm_storeu_si128((__m128i*)(dest + i), d);
+	}
+	replaceRowScalar(dest + i, src + i, count - i, shade, newColor);
+}
+#endif
+
+#ifdef BLIT_KERNELS_AVX2
+/*
+ * Same as shadeRowSSE2, 32 pixels at a time.
+ */
+BLIT_KERNELS_AVX2_TARGET void shadeRowAVX2(Uint8 *dest, const Uint8 *src, int count, int shade)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i group = _mm256_set1_epi8((char)helper::ColorGroup);
+	const __m256i black = _mm256_set1_epi8((char)helper::ColorShade);
+	const __m256i add = _mm256_set1_epi8((char)shade);
+	int i = 0;
+	for (; i + 32 <= count; i += 32)
+	{
+		__m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+		__m256i d = _mm256_loadu_si256((const __m256i*)(dest + i));
+		__m256i n = s;
+		if (shade)
+		{
+			n = _mm256_add_epi8(s, add);
+			__m256i sameGroup = _mm256_cmpeq_epi8(_mm256_and_si256(_mm256_xor_si256(n, s), group), zero);
+			n = _mm256_blendv_epi8(black, n, sameGroup);
+		}
+		d = _mm256_blendv_epi8(n, d, _mm256_cmpeq_epi8(s, zero));
+		_mm256_storeu_si256((__m256i*)(dest + i), d);
+	}
+	shadeRowScalar(dest + i, src + i, count - i, shade);
+}
+
+/*
+ * Same as replaceRowSSE2, 32 pixels at a time.
+ */
+BLIT_KERNELS_AVX2_TARGET void replaceRowAVX2(Uint8 *dest, const Uint8 *src, int count, int shade, int newColor)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i group = _mm256_set1_epi8((char)helper::ColorGroup);
+	const __m256i black = _mm256_set1_epi8((char)helper::ColorShade);
+	const __m256i add = _mm256_set1_epi8((char)shade);
+	const __m256i color = _mm256_set1_epi8((char)newColor);
+	int i = 0;
+	for (; i + 32 <= count; i += 32)
+	{
+		__m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+		__m256i d = _mm256_loadu_si256((const __m256i*)(dest + i));
+		__m256i n = _mm256_add_epi8(_mm256_and_si256(s, black), add);
+		__m256i sameGroup = _mm256_cmpeq_epi8(_mm256_and_si256(n, group), zero);
+		n = _mm256_blendv_epi8(black, _mm256_or_si256(color, n), sameGroup);
+		d = _mm256_blendv_epi8(n, d, _mm256_cmpeq_epi8(s, zero));
+		_mm256_storeu_si256((__m256i*)(dest + i), d);
+	}
+	replaceRowScalar(dest + i, src + i, count - i, shade, newColor);
+}
+
+/**
+ * Checks the AVX2 feature bit and that the OS saves the AVX registers.
+ * @return Does the CPU support AVX2?
+ */
+bool haveAVX2()
+{
+#ifdef __GNUC__
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2");
+#else
+	int CPUInfo[4];
+	__cpuid(CPUInfo, 1);
+	bool osxsave = (CPUInfo[2] & 0x08000000) != 0;
+	if (!osxsave || (_xgetbv(0) & 6) != 6)
+	{
+		return false;
+	}
+	__cpuidex(CPUInfo, 7, 0);
+	return (CPUInfo[1] & 0x20) != 0;
+#endif
+}
+#endif
+
+BlitKernelLevel getBestLevel()
+{
+#ifdef BLIT_KERNELS_AVX2
+	if (haveAVX2())
+	{
+		return BLIT_AVX2;
+	}
+#endif
+#ifdef __SSE2__
+	if (Zoom::haveSSE2())
+	{
+		return BLIT_SSE2;
+	}
+#endif
+	return BLIT_SCALAR;
+}
+
+const BlitKernelLevel supportedLevel = getBestLevel();
+BlitKernelLevel currentLevel = supportedLevel;
+ShadeRowFunc shadeRowFunc = nullptr;
+ReplaceRowFunc replaceRowFunc = nullptr;
+
+/**
+ * Picks the row blitters of the current level.
+ */
+void selectFunctions()
+{
+	shadeRowFunc = shadeRowScalar;
+	replaceRowFunc = replaceRowScalar;
+#ifdef __SSE2__
+	if (currentLevel == BLIT_SSE2)
+	{
+		shadeRowFunc = shadeRowSSE2;
+		replaceRowFunc = replaceRowSSE2;
+	}
+#endif
+#ifdef BLIT_KERNELS_AVX2
+	if (currentLevel == BLIT_AVX2)
+	{
+		shadeRowFunc = shadeRowAVX2;
+		replaceRowFunc = replaceRowAVX2;
+	}
+#endif
+}
+
+}
+
+/**
+ * Gets the best instruction set the row blitters
+ * can use on this CPU.
+ * @return Instruction set.
+ */
+BlitKernelLevel getSupportedLevel()
+{
+	return supportedLevel;
+}
+
+/**
+ * Gets the instruction set the row blitters use.
+ * @return Instruction set.
+ */
+BlitKernelLevel getLevel()
+{
+	return currentLevel;
+}
+
+/**
+ * Changes the instruction set the row blitters use,
+ * eg. to compare them. Unsupported sets are ignored.
+ * @param level Instruction set.
+ */
+void setLevel(BlitKernelLevel level)
+{
+	if (level <= supportedLevel)
+	{
+		currentLevel = level;
+		selectFunctions();
+	}
+}
+
+/**
+ * Gets the name of an instruction set.
+ * @param level Instruction set.
+ * @return Name for the log.
+ */
+const char *getLevelName(BlitKernelLevel level)
+{
+	switch (level)
+	{
+	case BLIT_AVX2:
+		return "AVX2";
+	case BLIT_SSE2:
+		return "SSE2";
+	default:
+		return "scalar";
+	}
+}
+
+/**
+ * Gets the pixels helper::StandardShade gives for every source pixel,
+ * so blits that can't be done a row at a time shade with one lookup.
+ * Entry 0 is transparent and should be skipped.
+ * @param shade Shade offset.
+ * @return Table of 256 pixels, or null if the shade isn't 0-15.
+ */
+const Uint8 *getShadeTable(int shade)
+{
+	if (shade < 0 || shade >= SHADE_TABLES)
+	{
+		return nullptr;
+	}
+	return shadeTables[shade].data();
+}
+
+/**
+ * Blits a row of pixels the same way as helper::StandardShade.
+ * A shade of 0 is a plain copy of the non-transparent pixels.
+ * @param dest First destination pixel.
+ * @param src First source pixel.
+ * @param count Number of pixels.
+ * @param shade Shade offset.
+ */
+void shadeRow(Uint8 *dest, const Uint8 *src, int count, int shade)
+{
+	if (!shadeRowFunc)
+	{
+		selectFunctions();
+	}
+	shadeRowFunc(dest, src, count, shade);
+}
+
+/**
+ * Blits a row of pixels the same way as helper::ColorReplace.
+ * @param dest First destination pixel.
+ * @param src First source pixel.
+ * @param count Number of pixels.
+ * @param shade Shade offset.
+ * @param newColor New color group, already shifted.
+ */
+void replaceRow(Uint8 *dest, const Uint8 *src, int count, int shade, int newColor)
+{
+	if (!replaceRowFunc)
+	{
+		selectFunctions();
+	}
+	replaceRowFunc(dest, src, count, shade, newColor);
+}
+
+/**
+ * Blits a sprite sized image all over a screen sized one with every
+ * kernel at every supported level, checks they all give the same
+ * picture as the scalar code and logs how long they took.
+ * @param rounds Number of times the screen is covered.
+ * @return False if a kernel gave a different result.
+ */
+bool benchmark(int rounds)
+{
+	const int spriteWidth = 32, spriteHeight = 40;
+	const int screenWidth = 320, screenHeight = 200;
+	std::vector<Uint8> sprite(spriteWidth * spriteHeight);
+	std::vector<Uint8> background(screenWidth * screenHeight);
+
+	// fixed pseudo-random pictures with about a third of transparent pixels
+	Uint32 seed = 12345;
+	auto next = [&seed]() { seed = seed * 1103515245 + 12345; return (seed >> 16) & 0xFF; };
+	for (auto &p : sprite)
+	{
+		p = next() % 3 ? next() : 0;
+	}
+	for (auto &p : background)
+	{
+		p = next();
+	}
+
+	struct Kernel
+	{
+		const char *name;
+		int shade, newColor;
+	};
+	const Kernel kernels[] = { { "copy", 0, 0 }, { "shade", 5, 0 }, { "recolor", 3, 0x40 } };
+
+	const BlitKernelLevel oldLevel = currentLevel;
+	std::vector<BenchmarkCounter> counters;
+	bool ok = true;
+	for (const auto &k : kernels)
+	{
+		std::vector<Uint8> reference;
+		for (int level = BLIT_SCALAR; level <= supportedLevel; ++level)
+		{
+			setLevel((BlitKernelLevel)level);
+			std::vector<Uint8> screen = background;
+			counters.push_back(BenchmarkCounter(std::string(k.name) + " " + getLevelName((BlitKernelLevel)level)));
+			{
+				BenchmarkScope scope(counters.back());
+				for (int r = 0; r < rounds; ++r)
+				{
+					for (int y = 0; y + spriteHeight <= screenHeight; y += spriteHeight / 2)
+					{
+						for (int x = (r + y) % 7; x + spriteWidth <= screenWidth; x += spriteWidth / 2)
+						{
+							for (int row = 0; row < spriteHeight; ++row)
+							{
+								Uint8 *dest = &screen[(y + row) * screenWidth + x];
+								const Uint8 *src = &sprite[row * spriteWidth];
+								if (k.newColor)
+									replaceRow(dest, src, spriteWidth, k.shade, k.newColor);
+								else
+									shadeRow(dest, src, spriteWidth, k.shade);
+							}
+						}
+					}
+				}
+			}
+			if (level == BLIT_SCALAR)
+			{
+				reference = screen;
+			}
+			else if (screen != reference)
+			{
+				Log(LOG_ERROR) << "Blit benchmark: " << counters.back().name << " differs from the scalar code.";
+				ok = false;
+			}
+		}
+	}
+	setLevel(oldLevel);
+
+	Benchmark::report("Blit benchmark: " + std::to_string(rounds) + " rounds, best level " + getLevelName(supportedLevel), counters);
+	return ok;
+}
+
+}
+
+}
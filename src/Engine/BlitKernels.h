@@ -0,0 +1,55 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <SDL_types.h>
+
+namespace OpenXcom
+{
+
+/**
+ * Instruction sets the row blitters can use.
+ */
+enum BlitKernelLevel { BLIT_SCALAR, BLIT_SSE2, BLIT_AVX2 };
+
+/**
+ * Row blitters for 8 bit palette surfaces, giving the same
+ * results as helper::StandardShade and helper::ColorReplace,
+ * using the best vector instructions the CPU supports.
+ */
+namespace BlitKernels
+{
+	/// Gets the best instruction set supported by this build and CPU.
+	BlitKernelLevel getSupportedLevel();
+	/// Gets the instruction set currently used.
+	BlitKernelLevel getLevel();
+	/// Changes the instruction set used, if supported.
+	void setLevel(BlitKernelLevel level);
+	/// Gets the name of an instruction set.
+	const char *getLevelName(BlitKernelLevel level);
+	/// Gets the pixels helper::StandardShade gives for a shade of 0-15.
+	const Uint8 *getShadeTable(int shade);
+	/// Blits a row skipping transparent pixels and shading the others.
+	void shadeRow(Uint8 *dest, const Uint8 *src, int count, int shade);
+	/// Blits a row skipping transparent pixels and recoloring the others.
+	void replaceRow(Uint8 *dest, const Uint8 *src, int count, int shade, int newColor);
+	/// Times every kernel at every supported level and logs the results.
+	bool benchmark(int rounds);
+}
+
+}
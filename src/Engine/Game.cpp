@@ -19,6 +19,7 @@
 #include "Game.h"
 #include "../resource.h"
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <sstream>
 #include <SDL_mixer.h>
@@ -34,11 +35,15 @@
 #include "../Savegame/SavedGame.h"
 #include "../Savegame/SavedBattleGame.h"
 #include "Action.h"
+#include "Benchmark.h"
 #include "Exception.h"
 #include "Options.h"
 #include "CrossPlatform.h"
 #include "FileMap.h"
+#include "Timer.h"
+#include "ScriptProfiler.h"
 #include "Unicode.h"
+#include "WorkerPool.h"
 #include "../Menu/TestState.h"
 #include <algorithm>
 #include "../fallthrough.h"
@@ -46,6 +51,24 @@
 namespace OpenXcom
 {
 
+namespace
+{
+
+/// Longest time between two frames even if nothing seems to change, in milliseconds.
+const Uint32 MAX_IDLE_FRAME_TIME = 250;
+
+/**
+ * Gets the time passed since a moment.
+ * @param start Starting moment.
+ * @return Time in microseconds.
+ */
+Uint32 elapsedMicroseconds(std::chrono::steady_clock::time_point start)
+{
+	return (Uint32)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
 const double Game::VOLUME_GRADIENT = 10.0;
 
 /**
@@ -101,6 +124,11 @@ Game::Game(const std::string &title) : _screen(0), _cursor(0), _lang(0), _save(0
 	_lang = new Language();
 
 	_timeOfLastFrame = 0;
+
+	if (!Options::getScriptProfile().empty())
+	{
+		ScriptProfiler::start(Options::getMasterUserFolder() + Options::getScriptProfile());
+	}
 }
 
 /**
@@ -124,6 +152,8 @@ Game::~Game()
 	delete _mod;
 	delete _screen;
 	delete _fpsCounter;
+	WorkerPool::shutdownShared();
+	ScriptProfiler::stop();
 
 	Mix_CloseAudio();
 
@@ -142,6 +172,9 @@ void Game::run()
 	static const ApplicationState stateRun[4] = { SLOWED, PAUSED, PAUSED, PAUSED };
 	// this will avoid processing SDL's resize event on startup, workaround for the heap allocation error it causes.
 	bool startupEvent = Options::allowResize;
+	// only draw frames when an event or a timer could have changed the screen
+	bool invalidated = true;
+	Uint32 thinkTime = 0;
 	while (!_quit)
 	{
 		// Clean up states
@@ -155,6 +188,7 @@ void Game::run()
 		if (!_init)
 		{
 			_init = true;
+			invalidated = true;
 			_states.back()->init();
 
 			// Unpress buttons
@@ -174,6 +208,7 @@ void Game::run()
 		// Process events
 		while (SDL_PollEvent(&_event))
 		{
+			invalidated = true;
 			if (CrossPlatform::isQuitShortcut(_event))
 				_event.type = SDL_QUIT;
 			switch (_event.type)
@@ -185,6 +220,8 @@ void Game::run()
 					// An event other than SDL_APPMOUSEFOCUS change happened.
 					if (reinterpret_cast<SDL_ActiveEvent*>(&_event)->state & ~SDL_APPMOUSEFOCUS)
 					{
+						// the window may have lost its contents meanwhile
+						_screen->redrawAll();
 						Uint8 currentState = SDL_GetAppState();
 						// Game is minimized
 						if (!(currentState & SDL_APPACTIVE))
@@ -215,6 +252,9 @@ void Game::run()
 						}
 					}
 					break;
+				case SDL_VIDEOEXPOSE:
+					_screen->redrawAll();
+					break;
 				case SDL_VIDEORESIZE:
 					if (Options::allowResize)
 					{
@@ -271,6 +311,35 @@ void Game::run()
 								Options::debugUi = !Options::debugUi;
 								_states.back()->redrawText();
 							}
+							// "ctrl-p" script profiler
+							else if (action.getDetails()->key.keysym.sym == SDLK_p && (SDL_GetModState() & KMOD_CTRL) != 0)
+							{
+								if (ScriptProfiler::enabled)
+								{
+									ScriptProfiler::stop();
+								}
+								else
+								{
+									const std::string &file = Options::getScriptProfile().empty() ? "scriptprofile.txt" : Options::getScriptProfile();
+									ScriptProfiler::start(Options::getMasterUserFolder() + file);
+								}
+							}
+							// "ctrl-o" engine section timers
+							else if (action.getDetails()->key.keysym.sym == SDLK_o && (SDL_GetModState() & KMOD_CTRL) != 0)
+							{
+								if (Benchmark::sectionsEnabled)
+								{
+									Benchmark::enableSections(false);
+									Benchmark::report("Engine sections:", Benchmark::getSections());
+									_fpsCounter->reportFrameTimes();
+								}
+								else
+								{
+									_fpsCounter->clearFrameTimes();
+									Benchmark::enableSections(true);
+									Log(LOG_INFO) << "Engine section timing started.";
+								}
+							}
 						}
 					}
 					_states.back()->handle(&action);
@@ -285,16 +354,22 @@ void Game::run()
 		}
 
 		// Process rendering
+		Uint32 frameInterval = 0;
 		if (runningState != PAUSED)
 		{
 			// Process logic
+			auto thinkStart = std::chrono::steady_clock::now();
+			Timer::beginPass();
 			_states.back()->think();
 			_fpsCounter->think();
+			invalidated = invalidated || Timer::hasFired();
+			thinkTime += elapsedMicroseconds(thinkStart);
 			if (Options::FPS > 0 && !(Options::useOpenGL && Options::vSyncForOpenGL))
 			{
 				// Update our FPS delay time based on the time of the last draw.
 				int fps = SDL_GetAppState() & SDL_APPINPUTFOCUS ? Options::FPS : Options::FPSInactive;
 
+				frameInterval = 1000 / fps;
 				_timeUntilNextFrame = (1000.0f / fps) - (SDL_GetTicks() - _timeOfLastFrame);
 			}
 			else
@@ -302,11 +377,12 @@ void Game::run()
 				_timeUntilNextFrame = 0;
 			}
 
-			if (_init && _timeUntilNextFrame <= 0)
+			if (_init && _timeUntilNextFrame <= 0 && (invalidated || SDL_GetTicks() - _timeOfLastFrame >= MAX_IDLE_FRAME_TIME))
 			{
 				// make a note of when this frame update occurred.
 				_timeOfLastFrame = SDL_GetTicks();
-				_fpsCounter->addFrame();
+				invalidated = false;
+				auto drawStart = std::chrono::steady_clock::now();
 				_screen->clear();
 				std::list<State*>::iterator i = _states.end();
 				do
@@ -321,7 +397,11 @@ void Game::run()
 				}
 				_fpsCounter->blit(_screen->getSurface());
 				_cursor->blit(_screen->getSurface());
+				Uint32 drawTime = elapsedMicroseconds(drawStart);
+				auto flipStart = std::chrono::steady_clock::now();
 				_screen->flip();
+				_fpsCounter->addFrame(thinkTime, drawTime, elapsedMicroseconds(flipStart));
+				thinkTime = 0;
 			}
 		}
 
@@ -329,14 +409,28 @@ void Game::run()
 		switch (runningState)
 		{
 			case RUNNING:
-				SDL_Delay(1); //Save CPU from going 100%
+				{
+					// sleep until a timer is due or a pending frame can be drawn,
+					// but wake up every frame anyway to keep input responsive
+					Uint32 wait = std::min(Timer::getTimeUntilNext(), std::max(frameInterval, 1u));
+					if (invalidated && frameInterval > 0)
+					{
+						Uint32 sinceLastFrame = SDL_GetTicks() - _timeOfLastFrame;
+						wait = std::min(wait, sinceLastFrame < frameInterval ? frameInterval - sinceLastFrame : 0u);
+					}
+					SDL_Delay(std::max(wait, 1u));
+				}
 				break;
 			case SLOWED: case PAUSED:
 				SDL_Delay(100); break; //More slowing down.
 		}
 	}
 
-	Options::save();
+	// benchmarks change some options for themselves
+	if (Options::getBenchmark().empty())
+	{
+		Options::save();
+	}
 }
 
 /**
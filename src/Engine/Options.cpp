@@ -27,6 +27,7 @@
 #include <sstream>
 #include <iostream>
 #include <algorithm>
+#include <cstdlib>
 #include <yaml-cpp/yaml.h>
 #include "Exception.h"
 #include "Logger.h"
@@ -55,6 +56,11 @@ std::string _masterMod;
 int _passwordCheck = -1;
 bool _loadLastSave = false;
 bool _loadLastSaveExpended = false;
+std::string _benchmark;
+std::string _benchmarkSave;
+int _benchmarkLength = 0;
+uint64_t _benchmarkSeed = 0;
+std::string _scriptProfile;
 
 /**
  * Sets up the options by creating their OptionInfo metadata.
@@ -76,6 +82,7 @@ void create()
 #endif
 
 	_info.push_back(OptionInfo("maxFrameSkip", &maxFrameSkip, 0));
+	_info.push_back(OptionInfo("workerThreads", &workerThreads, 0));
 	_info.push_back(OptionInfo("traceAI", &traceAI, false));
 	_info.push_back(OptionInfo("verboseLogging", &verboseLogging, false));
 	_info.push_back(OptionInfo("listVFSContents", &listVFSContents, false));
@@ -494,6 +501,27 @@ static void loadArgs()
 				{
 					_masterMod = argv[i];
 				}
+				else if (argname == "benchmark")
+				{
+					_benchmark = argv[i];
+					std::transform(_benchmark.begin(), _benchmark.end(), _benchmark.begin(), ::tolower);
+				}
+				else if (argname == "benchmarksave")
+				{
+					_benchmarkSave = argv[i];
+				}
+				else if (argname == "benchmarklength")
+				{
+					_benchmarkLength = std::max(0, atoi(argv[i].c_str()));
+				}
+				else if (argname == "benchmarkseed")
+				{
+					_benchmarkSeed = strtoull(argv[i].c_str(), 0, 10);
+				}
+				else if (argname == "scriptprofile")
+				{
+					_scriptProfile = argv[i];
+				}
 				else
 				{
 					//save this command line option for now, we will apply it later
@@ -526,6 +554,18 @@ static bool showHelp()
 	help << "        use PATH as the default Config Folder instead of auto-detecting" << std::endl << std::endl;
 	help << "-master MOD" << std::endl;
 	help << "        set MOD to the current master mod (eg. -master xcom2)" << std::endl << std::endl;
+	help << "-benchmark geoscape -benchmarkSave FILE [-benchmarkLength DAYS] [-benchmarkSeed SEED]" << std::endl;
+	help << "        run the geoscape logic of the save FILE for DAYS days at 1 Day speed without display and log the time spent" << std::endl << std::endl;
+	help << "-benchmark battlescape -benchmarkSave FILE [-benchmarkLength TURNS] [-benchmarkSeed SEED]" << std::endl;
+	help << "        play the battle in the save FILE for up to TURNS turns with the AI on all sides, without display," << std::endl;
+	help << "        and log the time spent and the outcome hash" << std::endl << std::endl;
+	help << "-benchmark blit [-benchmarkLength ROUNDS]" << std::endl;
+	help << "        time the sprite blitting kernels of every supported instruction set for ROUNDS rounds" << std::endl << std::endl;
+	help << "-benchmark globe [-benchmarkLength ROUNDS]" << std::endl;
+	help << "        time the globe shadow at every zoom level and supported instruction set for ROUNDS rounds" << std::endl << std::endl;
+	help << "-scriptProfile FILE" << std::endl;
+	help << "        count the runs, operations and time of every mod script, log them on exit and write them" << std::endl;
+	help << "        to FILE in the user folder as folded stacks for flame graph tools (in debug mode, ctrl-p toggles it)" << std::endl << std::endl;
 	help << "-KEY VALUE" << std::endl;
 	help << "        override option KEY with VALUE (eg. -displayWidth 640)" << std::endl << std::endl;
 	help << "-help" << std::endl;
@@ -848,6 +888,51 @@ void expendLoadLastSave()
 	_loadLastSaveExpended = true;
 }
 
+/**
+ * Gets the benchmark requested on the command line.
+ * @return Benchmark name, empty for a normal game.
+ */
+const std::string &getBenchmark()
+{
+	return _benchmark;
+}
+
+/**
+ * Gets the save file the benchmark runs on.
+ * @return Save filename, relative to the master user folder.
+ */
+const std::string &getBenchmarkSave()
+{
+	return _benchmarkSave;
+}
+
+/**
+ * Gets how long the benchmark runs.
+ * @return Length in the benchmark's own units, 0 for the default.
+ */
+int getBenchmarkLength()
+{
+	return _benchmarkLength;
+}
+
+/**
+ * Gets the RNG seed the benchmark runs with, so runs are reproducible.
+ * @return RNG seed.
+ */
+uint64_t getBenchmarkSeed()
+{
+	return _benchmarkSeed;
+}
+
+/**
+ * Gets the file the script profile is written to.
+ * @return Filename relative to the master user folder, empty if profiling wasn't asked for.
+ */
+const std::string &getScriptProfile()
+{
+	return _scriptProfile;
+}
+
 /**
  * Sets up the game's Data folder where the data file
  * are loaded from and the User folder and Config
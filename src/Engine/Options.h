@@ -18,6 +18,7 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <SDL.h>
+#include <cstdint>
 #include <string>
 #include <vector>
 #include "OptionInfo.h"
@@ -116,6 +117,16 @@ namespace Options
 	bool getLoadLastSave();
 	/// And do it only at startup
 	void expendLoadLastSave();
+	/// Gets the benchmark to run instead of the game.
+	const std::string &getBenchmark();
+	/// Gets the save file used by the benchmark.
+	const std::string &getBenchmarkSave();
+	/// Gets the length of the benchmark.
+	int getBenchmarkLength();
+	/// Gets the RNG seed used by the benchmark.
+	uint64_t getBenchmarkSeed();
+	/// Gets the file the script profile is written to.
+	const std::string &getScriptProfile();
 }
 
 }
@@ -0,0 +1,177 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ParallelScaler.h"
+#include <algorithm>
+#include <cstring>
+#include "Options.h"
+#include "Screen.h"
+#include "WorkerPool.h"
+#include "Zoom.h"
+#include "Scalers/hqx.h"
+#include "Scalers/xbrz.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Creates a scaler with no previous frame.
+ */
+ParallelScaler::ParallelScaler() : _buffer(0), _lastTarget(0), _lastFilter(FILTER_NONE), _lastWidth(0), _lastHeight(0), _valid(false)
+{
+}
+
+/**
+ *
+ */
+ParallelScaler::~ParallelScaler()
+{
+	if (_buffer != 0)
+	{
+		SDL_FreeSurface(_buffer);
+	}
+}
+
+/**
+ * Forgets the previous frame, for when the target
+ * surface was changed by something else.
+ */
+void ParallelScaler::invalidate()
+{
+	_valid = false;
+}
+
+/**
+ * Gets the surface the screen is scaled into when it has to be
+ * letterboxed. It's kept between frames so unchanged bands
+ * don't have to be scaled again.
+ * @param dst Display surface.
+ * @param width Width of the scaled image.
+ * @param height Height of the scaled image.
+ * @return Surface to scale into.
+ */
+SDL_Surface *ParallelScaler::getBuffer(const SDL_Surface *dst, int width, int height)
+{
+	if (_buffer == 0 || _buffer->w != width || _buffer->h != height || _buffer->format->BitsPerPixel != dst->format->BitsPerPixel)
+	{
+		if (_buffer != 0)
+		{
+			SDL_FreeSurface(_buffer);
+		}
+		_buffer = SDL_CreateRGBSurface(SDL_SWSURFACE, width, height, dst->format->BitsPerPixel, 0, 0, 0, 0);
+		_valid = false;
+	}
+	return _buffer;
+}
+
+/**
+ * Scales the source into the target with the hqx or xBRZ filter,
+ * the same as Zoom::_zoomSurfaceY() would. Only bands with
+ * source rows (or their neighbours) that differ from the last
+ * frame are redrawn, and they're drawn in parallel.
+ * @param src 32-bit source surface.
+ * @param dst 32-bit target surface, a whole multiple of the source size.
+ * @return False if neither filter applies to these surfaces.
+ */
+bool ParallelScaler::scale(SDL_Surface *src, SDL_Surface *dst)
+{
+	if (!Screen::use32bitScaler() || src->format->BytesPerPixel != 4 || dst->format->BytesPerPixel != 4 || src->w <= 0 || src->h <= 0)
+	{
+		return false;
+	}
+	const int factor = dst->w / src->w;
+	if (dst->w != src->w * factor || dst->h != src->h * factor)
+	{
+		return false;
+	}
+	ScalerFilter filter;
+	if (Options::useXBRZFilter && factor >= 2 && factor <= 6)
+	{
+		filter = FILTER_XBRZ;
+	}
+	else if (Options::useHQXFilter && factor >= 2 && factor <= 4)
+	{
+		filter = FILTER_HQX;
+		Zoom::initHQX();
+	}
+	else
+	{
+		return false;
+	}
+
+	const int width = src->w;
+	const int height = src->h;
+	// hardware double buffers swap every flip, so their contents are unknown
+	const bool keepsContents = !((dst->flags & SDL_HWSURFACE) && (dst->flags & SDL_DOUBLEBUF));
+	const bool whole = !_valid || !keepsContents || dst != _lastTarget || filter != _lastFilter || width != _lastWidth || height != _lastHeight;
+	_previous.resize(width * height);
+	_changed.assign(height, whole);
+	for (int y = 0; y < height; ++y)
+	{
+		const Uint8 *row = (const Uint8*)src->pixels + y * src->pitch;
+		Uint32 *previous = &_previous[y * width];
+		if (whole || memcmp(previous, row, width * 4) != 0)
+		{
+			memcpy(previous, row, width * 4);
+			_changed[y] = 1;
+		}
+	}
+	_valid = true;
+	_lastTarget = dst;
+	_lastFilter = filter;
+	_lastWidth = width;
+	_lastHeight = height;
+
+	_bands.clear();
+	for (int y = 0; y < height; y += BAND_HEIGHT)
+	{
+		int first = std::max(y - FILTER_RADIUS, 0);
+		int last = std::min(y + BAND_HEIGHT + FILTER_RADIUS, height);
+		if (std::find(_changed.begin() + first, _changed.begin() + last, 1) != _changed.begin() + last)
+		{
+			_bands.push_back(y);
+		}
+	}
+
+	const uint32_t *srcPixels = (const uint32_t*)src->pixels;
+	uint32_t *dstPixels = (uint32_t*)dst->pixels;
+	WorkerPool::getShared()->run((int)_bands.size(), [&](int i)
+	{
+		int first = _bands[i];
+		int last = std::min(first + BAND_HEIGHT, height);
+		if (filter == FILTER_XBRZ)
+		{
+			xbrz::scale(factor, srcPixels, dstPixels, width, height, xbrz::RGB, xbrz::ScalerCfg(), first, last);
+		}
+		else if (factor == 2)
+		{
+			hq2x_32_rb_slice(srcPixels, src->pitch, dstPixels, dst->pitch, width, height, first, last);
+		}
+		else if (factor == 3)
+		{
+			hq3x_32_rb_slice(srcPixels, src->pitch, dstPixels, dst->pitch, width, height, first, last);
+		}
+		else
+		{
+			hq4x_32_rb_slice(srcPixels, src->pitch, dstPixels, dst->pitch, width, height, first, last);
+		}
+	});
+	return true;
+}
+
+}
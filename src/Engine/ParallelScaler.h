@@ -0,0 +1,62 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vector>
+#include <SDL.h>
+
+namespace OpenXcom
+{
+
+/**
+ * Runs the 32-bit hqx and xBRZ filters of the screen in
+ * horizontal bands spread over the worker pool. Keeps a copy
+ * of the last source frame so bands whose source rows
+ * haven't changed are left as they are in the target.
+ */
+class ParallelScaler
+{
+private:
+	/// Source rows in a band, xBRZ works best with 8-16.
+	static const int BAND_HEIGHT = 16;
+	/// Source rows above and below a pixel that both filters look at.
+	static const int FILTER_RADIUS = 2;
+	enum ScalerFilter { FILTER_NONE, FILTER_HQX, FILTER_XBRZ };
+
+	std::vector<Uint32> _previous;
+	std::vector<char> _changed;
+	std::vector<int> _bands;
+	SDL_Surface *_buffer;
+	const SDL_Surface *_lastTarget;
+	ScalerFilter _lastFilter;
+	int _lastWidth, _lastHeight;
+	bool _valid;
+public:
+	/// Creates a scaler.
+	ParallelScaler();
+	/// Cleans up the scaler.
+	~ParallelScaler();
+	/// Forces the next frame to be scaled whole.
+	void invalidate();
+	/// Gets a surface to scale into before letterboxing.
+	SDL_Surface *getBuffer(const SDL_Surface *dst, int width, int height);
+	/// Scales the changed parts of a frame with the 32-bit filters.
+	bool scale(SDL_Surface *src, SDL_Surface *dst);
+};
+
+}
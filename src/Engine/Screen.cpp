@@ -112,7 +112,7 @@ void Screen::makeVideoFlags()
  * Initializes a new display screen for the game to render contents to.
  * The screen is set up based on the current options.
  */
-Screen::Screen() : _baseWidth(ORIGINAL_WIDTH), _baseHeight(ORIGINAL_HEIGHT), _scaleX(1.0), _scaleY(1.0), _flags(0), _numColors(0), _firstColor(0), _pushPalette(false), _flickerFix(false)
+Screen::Screen() : _baseWidth(ORIGINAL_WIDTH), _baseHeight(ORIGINAL_HEIGHT), _scaleX(1.0), _scaleY(1.0), _flags(0), _numColors(0), _firstColor(0), _pushPalette(false), _flickerFix(false), _redrawAll(true)
 {
 	_flickerFix = Options::oxceEnablePaletteFlickerFix;
 
@@ -181,15 +181,89 @@ void Screen::handle(Action *action)
 }
 
 
+/**
+ * Compares the buffer with what was last put on screen
+ * and remembers its contents for the next frame.
+ * @param damage Set to the part of the buffer that changed.
+ * @return False if nothing changed since the last flip.
+ */
+bool Screen::findDamage(SDL_Rect &damage)
+{
+	const int bytes = _surface->format->BytesPerPixel;
+	const int rowBytes = _surface->w * bytes;
+	const bool whole = _redrawAll || _lastFrame.size() != (size_t)rowBytes * _surface->h;
+	_lastFrame.resize((size_t)rowBytes * _surface->h);
+
+	int top = _surface->h, bottom = -1, left = rowBytes, right = -1;
+	for (int y = 0; y < _surface->h; ++y)
+	{
+		const Uint8 *row = (const Uint8*)_surface->pixels + y * _surface->pitch;
+		Uint8 *last = &_lastFrame[(size_t)y * rowBytes];
+		if (whole || memcmp(last, row, rowBytes) != 0)
+		{
+			top = std::min(top, y);
+			bottom = y;
+			if (!whole)
+			{
+				int l = 0, r = rowBytes - 1;
+				while (last[l] == row[l])
+				{
+					++l;
+				}
+				while (last[r] == row[r])
+				{
+					--r;
+				}
+				left = std::min(left, l);
+				right = std::max(right, r);
+			}
+			memcpy(last, row, rowBytes);
+		}
+	}
+	_redrawAll = false;
+	if (bottom < 0)
+	{
+		return false;
+	}
+	if (whole)
+	{
+		left = 0;
+		right = rowBytes - 1;
+	}
+	damage.x = left / bytes;
+	damage.y = top;
+	damage.w = right / bytes - damage.x + 1;
+	damage.h = bottom - top + 1;
+	return true;
+}
+
 /**
  * Renders the buffer's contents onto the screen, applying
  * any necessary filters or conversions in the process.
  * If the scaling factor is bigger than 1, the entire contents
  * of the buffer are resized by that factor (eg. 2 = doubled)
  * before being put on screen.
+ * Frames identical to the last one aren't put on screen at all,
+ * and on displays that keep their contents only the part of the
+ * window that changed is updated.
  */
 void Screen::flip()
 {
+	const bool whole = _redrawAll;
+	SDL_Rect damage;
+	if (!findDamage(damage))
+	{
+		return;
+	}
+	// hardware double buffers swap every flip, so their contents are unknown
+	const bool keepsContents = !useOpenGL() && !((_screen->flags & SDL_HWSURFACE) && (_screen->flags & SDL_DOUBLEBUF));
+	const bool partial = keepsContents && !whole;
+	if (!partial && !useOpenGL() && (_topBlackBand > 0 || _bottomBlackBand > 0 || _leftBlackBand > 0 || _rightBlackBand > 0))
+	{
+		Surface::CleanSdlSurface(_screen);
+		_scaler.invalidate();
+	}
+
 	// perform any requested palette update
 	if (_flickerFix && _pushPalette && _numColors && _screen->format->BitsPerPixel == 8)
 	{
@@ -201,9 +275,33 @@ void Screen::flip()
 		_pushPalette = false;
 	}
 
+	SDL_Rect update = {0, 0, 0, 0};
 	if (getWidth() != _baseWidth || getHeight() != _baseHeight || useOpenGL())
 	{
-		Zoom::flipWithZoom(_surface.get(), _screen, _topBlackBand, _bottomBlackBand, _leftBlackBand, _rightBlackBand, &glOutput);
+		Zoom::flipWithZoom(_surface.get(), _screen, _topBlackBand, _bottomBlackBand, _leftBlackBand, _rightBlackBand, &glOutput, &_scaler);
+		if (partial)
+		{
+			// the filters blend in neighbouring pixels, so update a bit more than what changed
+			const int width = getWidth() - _leftBlackBand - _rightBlackBand;
+			const int height = getHeight() - _topBlackBand - _bottomBlackBand;
+			const double scaleX = width / (double)_surface->w;
+			const double scaleY = height / (double)_surface->h;
+			const int margin = 2;
+			int x1 = std::max(0, (int)std::floor((damage.x - margin) * scaleX));
+			int y1 = std::max(0, (int)std::floor((damage.y - margin) * scaleY));
+			int x2 = std::min(width, (int)std::ceil((damage.x + damage.w + margin) * scaleX));
+			int y2 = std::min(height, (int)std::ceil((damage.y + damage.h + margin) * scaleY));
+			update.x = x1 + _leftBlackBand;
+			update.y = y1 + _topBlackBand;
+			update.w = x2 - x1;
+			update.h = y2 - y1;
+		}
+	}
+	else if (partial)
+	{
+		SDL_Rect target = damage;
+		SDL_BlitSurface(_surface.get(), &damage, _screen, &target);
+		update = damage;
 	}
 	else
 	{
@@ -221,9 +319,11 @@ void Screen::flip()
 		_pushPalette = false;
 	}
 
-
-
-	if (SDL_Flip(_screen) == -1)
+	if (partial)
+	{
+		SDL_UpdateRect(_screen, update.x, update.y, update.w, update.h);
+	}
+	else if (SDL_Flip(_screen) == -1)
 	{
 		throw Exception(SDL_GetError());
 	}
@@ -231,11 +331,21 @@ void Screen::flip()
 
 /**
  * Clears all the contents out of the internal buffer.
+ * The display itself is left alone, the next flip
+ * overwrites whatever changed.
  */
 void Screen::clear()
 {
 	Surface::CleanSdlSurface(_surface.get());
-	Surface::CleanSdlSurface(_screen);
+}
+
+/**
+ * Makes the next flip put the whole buffer on screen,
+ * for when the window contents were lost or the palette changed.
+ */
+void Screen::redrawAll()
+{
+	_redrawAll = true;
 }
 
 /**
@@ -263,6 +373,8 @@ void Screen::setPalette(const SDL_Color* colors, int firstcolor, int ncolors, bo
 	}
 
 	SDL_SetColors(_surface.get(), const_cast<SDL_Color *>(colors), firstcolor, ncolors);
+	// the buffer's pixels may not change at all, but the screen still has to
+	_redrawAll = true;
 
 	// defer actual update of screen until SDL_Flip()
 	if (immediately && _screen->format->BitsPerPixel == 8 && SDL_SetColors(_screen, const_cast<SDL_Color *>(colors), firstcolor, ncolors) == 0)
@@ -328,6 +440,8 @@ void Screen::resetDisplay(bool resetVideo, bool noShaders)
 	Uint32 oldFlags = _flags;
 #endif
 	makeVideoFlags();
+	_scaler.invalidate();
+	_redrawAll = true;
 
 	if (!_surface || (_surface->format->BitsPerPixel != _bpp ||
 		_surface->w != _baseWidth ||
@@ -19,7 +19,9 @@
  */
 #include <SDL.h>
 #include <string>
+#include <vector>
 #include "OpenGL.h"
+#include "ParallelScaler.h"
 #include "Surface.h"
 
 namespace OpenXcom
@@ -49,11 +51,16 @@ private:
 	int _numColors, _firstColor;
 	bool _pushPalette;
 	bool _flickerFix;
+	bool _redrawAll;
+	std::vector<Uint8> _lastFrame;
 	OpenGL glOutput;
+	ParallelScaler _scaler;
 	Surface::UniqueBufferPtr _buffer;
 	Surface::UniqueSurfacePtr _surface;
 	/// Sets the _flags and _bpp variables based on game options; needed in more than one place now
 	void makeVideoFlags();
+	/// Finds the part of the buffer that changed since the last flip.
+	bool findDamage(SDL_Rect &damage);
 public:
 	static const int ORIGINAL_WIDTH;
 	static const int ORIGINAL_HEIGHT;
@@ -74,6 +81,8 @@ public:
 	void flip();
 	/// Clears the screen.
 	void clear();
+	/// Makes the next flip redraw the whole screen.
+	void redrawAll();
 	/// Sets the screen's 8bpp palette.
 	void setPalette(const SDL_Color *colors, int firstcolor = 0, int ncolors = 256, bool immediately = false);
 	/// Gets the screen's 8bpp palette.
@@ -24,11 +24,15 @@
 #include <cmath>
 #include <bitset>
 #include <array>
+#include <chrono>
 
+#include "Benchmark.h"
+#include "BlitKernels.h"
 #include "Logger.h"
 #include "Options.h"
 #include "Script.h"
 #include "ScriptBind.h"
+#include "ScriptProfiler.h"
 #include "Surface.h"
 #include "ShaderDraw.h"
 #include "ShaderMove.h"
@@ -69,7 +73,7 @@ namespace OpenXcom
 //						proc definition
 ////////////////////////////////////////////////////////////
 [[gnu::always_inline]]
-static inline void addShade_h(int& reg, const int& var)
+static inline void addShadeCalc_h(int& reg, const int& var)
 {
 	const int newShade = (reg & 0xF) + var;
 	if (newShade > 0xF)
@@ -89,6 +93,36 @@ static inline void addShade_h(int& reg, const int& var)
 		reg = 0x01;
 }
 
+/**
+ * Results of add_shade for every pixel and the shades 0-15, the ones
+ * that come from blit shading, indexed by shade then pixel.
+ */
+static const std::array<std::array<Uint8, 256>, 16> addShadeTable = []
+{
+	std::array<std::array<Uint8, 256>, 16> table;
+	for (int shade = 0; shade < 16; ++shade)
+	{
+		for (int pixel = 0; pixel < 256; ++pixel)
+		{
+			int reg = pixel;
+			addShadeCalc_h(reg, shade);
+			table[shade][pixel] = reg;
+		}
+	}
+	return table;
+}();
+
+[[gnu::always_inline]]
+static inline void addShade_h(int& reg, const int& var)
+{
+	if ((unsigned)reg < 256u && (unsigned)var < 16u)
+	{
+		reg = addShadeTable[var][reg];
+		return;
+	}
+	addShadeCalc_h(reg, var);
+}
+
 [[gnu::always_inline]]
 static inline RetEnum mulAddMod_h(int& reg, const int& mul, const int& add, const int& mod)
 {
@@ -382,11 +416,13 @@ enum ProcEnum : Uint8
 /**
  * Core function in script engine used to executing scripts
  * @param proc array storing operation of script
- * @return Result of executing script
+ * @param curr position of first operation to execute
+ * @return Number of operations executed, if they are counted.
  */
-static inline void scriptExe(ScriptWorkerBase& data, const Uint8* proc)
+template<bool CountOps>
+static inline uint64_t scriptExe(ScriptWorkerBase& data, const Uint8* proc, ProgPos curr = ProgPos::Start)
 {
-	ProgPos curr = ProgPos::Start;
+	uint64_t ops = 0;
 	//--------------------------------------------------
 	//			helper macros for this function
 	//--------------------------------------------------
@@ -417,6 +453,10 @@ static inline void scriptExe(ScriptWorkerBase& data, const Uint8* proc)
 
 	while (true)
 	{
+		if constexpr (CountOps)
+		{
+			++ops;
+		}
 		switch (proc[(int)curr++])
 		{
 		MACRO_COPY_256(MACRO_FUNC_ARRAY_LOOP, 0)
@@ -438,7 +478,86 @@ static inline void scriptExe(ScriptWorkerBase& data, const Uint8* proc)
 	}
 
 	endLabel:
-	return;
+	return ops;
+}
+
+/**
+ * Executes one script for many workers at once. Every operation is
+ * dispatched once and then done by all workers, as long as they
+ * all go the same way. When a branch splits them up, or one of them
+ * stops, each finishes the script alone from where it got to.
+ * Workers must not depend on each other, eg. scripts that write
+ * to log would mix up their lines.
+ * @param data workers to execute script for
+ * @param count number of workers, at most ScriptBatchMax
+ * @param proc array storing operation of script
+ */
+static inline void scriptExeBatch(ScriptWorkerBase* const* data, int count, const Uint8* proc)
+{
+	ProgPos curr = ProgPos::Start;
+	ProgPos next[ScriptBatchMax];
+	RetEnum ret[ScriptBatchMax];
+	//--------------------------------------------------
+	//			helper macros for this function
+	//--------------------------------------------------
+	#define MACRO_FUNC_ARRAY(NAME, ...) + helper::FuncGroup<MACRO_FUNC_ID(NAME)>::FuncList{}
+	#define MACRO_FUNC_ARRAY_LOOP(POS) \
+		case (POS): \
+		{ \
+			using currType = helper::GetType<func, POS>; \
+			const auto p = proc + (int)curr; \
+			for (int i = 0; i < count; ++i) \
+			{ \
+				next[i] = curr; \
+				next[i] += currType::offset; \
+				ret[i] = currType::func(*data[i], p, next[i]); \
+			} \
+			break; \
+		}
+	//--------------------------------------------------
+
+	using func = decltype(MACRO_PROC_DEFINITION(MACRO_FUNC_ARRAY));
+
+	while (true)
+	{
+		const ProgPos op = curr++;
+		switch (proc[(int)op])
+		{
+		MACRO_COPY_256(MACRO_FUNC_ARRAY_LOOP, 0)
+		}
+
+		bool together = true;
+		for (int i = 0; i < count; ++i)
+		{
+			together &= ret[i] == RetContinue && next[i] == next[0];
+		}
+		if (together)
+		{
+			curr = next[0];
+			continue;
+		}
+
+		for (int i = 0; i < count; ++i)
+		{
+			if (ret[i] == RetContinue)
+			{
+				scriptExe<false>(*data[i], proc, next[i]);
+			}
+			else if (ret[i] != RetEnd)
+			{
+				// operation failed, run it again alone to report it same way
+				scriptExe<false>(*data[i], proc, op);
+			}
+		}
+		return;
+	}
+
+	//--------------------------------------------------
+	//			removing helper macros
+	//--------------------------------------------------
+	#undef MACRO_FUNC_ARRAY_LOOP
+	#undef MACRO_FUNC_ARRAY
+	//--------------------------------------------------
 }
 
 
@@ -446,6 +565,196 @@ static inline void scriptExe(ScriptWorkerBase& data, const Uint8* proc)
 //						Script class
 ////////////////////////////////////////////////////////////
 
+/// Most register states remembered for one pure script, a newer state replaces an older one with the same slot.
+constexpr size_t ScriptMemoMax = 256;
+/// Smallest pure script worth remembering, shorter ones are faster to run than to look up.
+constexpr size_t ScriptMemoMinProc = 64;
+
+/**
+ * Runs a script, recording it in the profiler when that's enabled.
+ * @param script Script to run.
+ */
+inline void ScriptWorkerBase::runScript(const ScriptContainerBase& script)
+{
+	if (ScriptProfiler::enabled)
+	{
+		auto start = std::chrono::steady_clock::now();
+		uint64_t ops = scriptExe<true>(*this, script.data());
+		auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+		ScriptProfiler::record(script.getProfileId(), ops, time);
+	}
+	else
+	{
+		scriptExe<false>(*this, script.data());
+	}
+}
+
+/**
+ * Runs a script. Pure scripts only change their registers based
+ * on what was in them, so the registers they leave are remembered
+ * by the registers they got and restored the next time they get
+ * the same ones, without running the script. Nothing is remembered
+ * while profiling, so every run is counted.
+ * @param script Script to run.
+ */
+inline void ScriptWorkerBase::executeScript(const ScriptContainerBase& script)
+{
+	const size_t size = script._regUsed;
+	if (ScriptProfiler::enabled || script._purity != ScriptPure || script._proc.size() < ScriptMemoMinProc)
+	{
+		runScript(script);
+		return;
+	}
+
+	const Uint8* regs = reinterpret_cast<const Uint8*>(&reg);
+	uint64_t hash = 14695981039346656037ULL;
+	for (size_t i = 0; i < size; ++i)
+	{
+		hash = (hash ^ regs[i]) * 1099511628211ULL;
+	}
+	// zero marks an empty slot
+	hash |= 1;
+
+	// each slot keeps the hash, the registers given and the registers left,
+	// all slots are allocated with the first run
+	const size_t slotSize = sizeof(hash) + 2 * size;
+	if (script._memo.empty())
+	{
+		script._memo.resize(ScriptMemoMax * slotSize);
+	}
+	Uint8* slot = script._memo.data() + ((hash >> 8) % ScriptMemoMax) * slotSize;
+	uint64_t slotHash;
+	memcpy(&slotHash, slot, sizeof(slotHash));
+	if (slotHash == hash && memcmp(slot + sizeof(hash), regs, size) == 0)
+	{
+		memcpy(&reg, slot + sizeof(hash) + size, size);
+		return;
+	}
+	memcpy(slot, &hash, sizeof(hash));
+	memcpy(slot + sizeof(hash), regs, size);
+	runScript(script);
+	memcpy(slot + sizeof(hash) + size, regs, size);
+}
+
+/**
+ * Checks if the current script and events only read, so
+ * each pair of pixels gives the same color in one blit.
+ * @param regUsed Set to the size of registers used by the scripts.
+ * @return True if the colors can be remembered.
+ */
+bool ScriptWorkerBlit::canMemoBlit(size_t& regUsed) const
+{
+	if (_proc->getPurity() == ScriptImpure)
+	{
+		return false;
+	}
+	regUsed = _proc->getRegUsed();
+	if (_events)
+	{
+		auto ptr = _events;
+		for (int list = 0; list < 2; ++list)
+		{
+			while (*ptr)
+			{
+				if (ptr->getPurity() == ScriptImpure)
+				{
+					return false;
+				}
+				regUsed = std::max(regUsed, ptr->getRegUsed());
+				++ptr;
+			}
+			++ptr;
+		}
+	}
+	return true;
+}
+
+/**
+ * Checks if the current script or events name the value
+ * put in registers at the offset.
+ * @param offset Offset of the value in registers.
+ * @return True if any script names it.
+ */
+bool ScriptWorkerBlit::isRegNamed(size_t offset) const
+{
+	if (_proc && _proc->isRegNamed(offset))
+	{
+		return true;
+	}
+	if (_events)
+	{
+		auto ptr = _events;
+		for (int list = 0; list < 2; ++list)
+		{
+			while (*ptr)
+			{
+				if (ptr->isRegNamed(offset))
+				{
+					return true;
+				}
+				++ptr;
+			}
+			++ptr;
+		}
+	}
+	return false;
+}
+
+/**
+ * Gets what the current script and events depend on besides
+ * their registers, the most of all of them.
+ * @return Purity of the scripts.
+ */
+ScriptPurity ScriptWorkerBlit::getPurity() const
+{
+	ScriptPurity purity = _proc ? _proc->getPurity() : ScriptPure;
+	if (_events)
+	{
+		auto ptr = _events;
+		for (int list = 0; list < 2; ++list)
+		{
+			while (*ptr)
+			{
+				purity = std::max(purity, ptr->getPurity());
+				++ptr;
+			}
+			++ptr;
+		}
+	}
+	return purity;
+}
+
+/**
+ * Checks if the scripts give the same colors on any background
+ * and in any state of the objects they get, so a sprite blitted
+ * with them can be kept and blitted again while the arguments
+ * stay the same.
+ * @return True if the blit can be reused.
+ */
+bool ScriptWorkerBlit::canReuseBlit() const
+{
+	// old pixel is the second output value
+	return !ScriptProfiler::enabled && getPurity() == ScriptPure && !isArgNamed(1);
+}
+
+/**
+ * Runs a script for many workers at once.
+ * @param workers Workers to run script for.
+ * @param count Number of workers, at most ScriptBatchMax.
+ * @param script Script to run.
+ */
+void ScriptWorkerBase::executeBatch(ScriptWorkerBase* const* workers, int count, const ScriptContainerBase& script)
+{
+	if (count == 1)
+	{
+		scriptExe<false>(*workers[0], script.data());
+	}
+	else if (count > 1)
+	{
+		scriptExeBatch(workers, count, script.data());
+	}
+}
+
 void ScriptWorkerBlit::executeBlit(Surface* src, Surface* dest, int x, int y, int shade)
 {
 	executeBlit(src, dest, x, y, shade, GraphSubset{ dest->getWidth(), dest->getHeight() } );
@@ -466,7 +775,105 @@ void ScriptWorkerBlit::executeBlit(Surface* src, Surface* dest, int x, int y, in
 
 	if (_proc)
 	{
-		if (_events)
+		size_t regUsed = 0;
+		if (!ScriptProfiler::enabled && canMemoBlit(regUsed))
+		{
+			// nothing can change while blitting, so scripts that only read
+			// give the same color every time they get the same two pixels,
+			// and pixels still missing a color are run together in batches
+			Uint32 memo[256] = { };
+			ScriptWorkerBlit lanes[ScriptBatchMax];
+			ScriptWorkerBase* workers[ScriptBatchMax];
+			ScriptWorkerBlit::Output args[ScriptBatchMax];
+			Uint8* pixels[ScriptBatchMax];
+			Uint32 keys[ScriptBatchMax];
+			int count = 0;
+			for (int i = 0; i < ScriptBatchMax; ++i)
+			{
+				workers[i] = &lanes[i];
+			}
+
+			auto executeLanes = [&](const ScriptContainerBase& script)
+			{
+				for (int i = 0; i < count; ++i)
+				{
+					lanes[i].reset(args[i]);
+				}
+				executeBatch(workers, count, script);
+			};
+			auto flush = [&]
+			{
+				for (int i = 0; i < count; ++i)
+				{
+					lanes[i].copyRegs(*this, regUsed);
+					lanes[i].set(args[i]);
+				}
+
+				auto ptr = _events;
+				if (ptr)
+				{
+					while (*ptr)
+					{
+						executeLanes(*ptr);
+						++ptr;
+					}
+					++ptr;
+				}
+
+				executeLanes(*_proc);
+
+				if (ptr)
+				{
+					while (*ptr)
+					{
+						executeLanes(*ptr);
+						++ptr;
+					}
+				}
+
+				for (int i = 0; i < count; ++i)
+				{
+					Uint8& destStuff = *pixels[i];
+					lanes[i].get(args[i]);
+					if (args[i].getFirst()) destStuff = args[i].getFirst();
+					memo[keys[i] >> 17] = (keys[i] & 0x1FFFF) | (destStuff << 24);
+				}
+				count = 0;
+			};
+
+			ShaderDrawRows(
+				[&](int size, Uint8& destRow, const Uint8& srcRow)
+				{
+					Uint8* destStuff = &destRow;
+					const Uint8* srcStuff = &srcRow;
+					for (int i = 0; i < size; ++i)
+					{
+						if (srcStuff[i])
+						{
+							const Uint32 index = (srcStuff[i] + destStuff[i] * 67) & 0xFF;
+							const Uint32 key = 0x10000 | (srcStuff[i] << 8) | destStuff[i];
+							const Uint32 entry = memo[index];
+							if ((entry & 0x1FFFF) == key)
+							{
+								destStuff[i] = entry >> 24;
+								continue;
+							}
+
+							args[count] = { srcStuff[i], destStuff[i] };
+							pixels[count] = &destStuff[i];
+							keys[count] = key | (index << 17);
+							if (++count == ScriptBatchMax)
+							{
+								flush();
+							}
+						}
+					}
+				},
+				destShader, srcShader
+			);
+			flush();
+		}
+		else if (_events)
 		{
 			ShaderDrawFunc(
 				[&](Uint8& destStuff, const Uint8& srcStuff)
@@ -479,18 +886,18 @@ void ScriptWorkerBlit::executeBlit(Surface* src, Surface* dest, int x, int y, in
 						while (*ptr)
 						{
 							reset(arg);
-							scriptExe(*this, ptr->data());
+							executeScript(*ptr);
 							++ptr;
 						}
 						++ptr;
 
 						reset(arg);
-						scriptExe(*this, _proc);
+						executeScript(*_proc);
 
 						while (*ptr)
 						{
 							reset(arg);
-							scriptExe(*this, ptr->data());
+							executeScript(*ptr);
 							++ptr;
 						}
 						++ptr;
@@ -512,7 +919,7 @@ void ScriptWorkerBlit::executeBlit(Surface* src, Surface* dest, int x, int y, in
 					{
 						ScriptWorkerBlit::Output arg = { srcStuff, destStuff };
 						set(arg);
-						scriptExe(*this, _proc);
+						executeScript(*_proc);
 						get(arg);
 						if (arg.getFirst()) destStuff = arg.getFirst();
 					}
@@ -524,19 +931,26 @@ void ScriptWorkerBlit::executeBlit(Surface* src, Surface* dest, int x, int y, in
 	}
 	else
 	{
-		ShaderDraw<helper::StandardShade>(destShader, srcShader, ShaderScalar(shade));
+		ShaderDrawRows(
+			[](int count, Uint8& destStuff, const Uint8& srcStuff, const int& shade)
+			{
+				BlitKernels::shadeRow(&destStuff, &srcStuff, count, shade);
+			},
+			destShader, srcShader, ShaderScalar(shade)
+		);
 	}
 }
 
 /**
  * Execute script with two arguments.
- * @return Result value from script.
+ * @param script Script to run, nothing happens if it's empty.
  */
-void ScriptWorkerBase::executeBase(const Uint8* proc)
+void ScriptWorkerBase::executeBase(const ScriptContainerBase& script)
 {
-	if (proc)
+	if (script)
 	{
-		scriptExe(*this, proc);
+		BenchmarkSectionScope benchmark(BENCHMARK_SCRIPTS);
+		executeScript(script);
 	}
 }
 
@@ -804,6 +1218,7 @@ bool parseCustomProc(const ScriptProcData& spd, ParserWriter& ph, const ScriptRe
 	static_assert(std::is_same<helper::GetType<helper::FuncGroup<Func_call>, 1>, argRaw>::value, "Invalid second argument");
 
 	auto opPos = ph.pushProc(Proc_call);
+	ph.updatePurity(spd.readOnly ? ScriptReadOnly : ScriptImpure);
 
 	auto funcPos = ph.pushReserved<ScriptFunc>();
 	auto argPosBegin = ph.getCurrPos();
@@ -1851,6 +2266,15 @@ ScriptRefData ParserWriter::getReferece(const ScriptRef& s) const
 	if (ptr == nullptr)
 	{
 		ptr = parser.getRef(s);
+		if (ptr && ptr->isValueType<RegEnum>())
+		{
+			// arguments of the script, remember which are used
+			const size_t offset = static_cast<size_t>(ptr->getValue<RegEnum>());
+			if (offset < 64)
+			{
+				container._regNamed |= Uint64{ 1 } << offset;
+			}
+		}
 	}
 	if (ptr == nullptr)
 	{
@@ -1948,6 +2372,15 @@ void ParserWriter::updateProc(ReservedPos<ProcOp> pos, int procOffset)
 	container._proc[static_cast<size_t>(pos.getPos())] += procOffset;
 }
 
+/**
+ * Lower what is known about side effects of script, it can't get better.
+ * @param purity What the current operation depends on.
+ */
+void ParserWriter::updatePurity(ScriptPurity purity)
+{
+	container._purity = std::max(container._purity, purity);
+}
+
 /**
  * Try pushing label arg on proc vector. Can't use this to create loop back label.
  * @param s name of label.
@@ -2211,7 +2644,7 @@ ScriptRef ScriptParserBase::addNameRef(const std::string& s)
  * @param s function name
  * @param parser parsing function
  */
-void ScriptParserBase::addParserBase(const std::string& s, const std::string& description, ScriptProcData::overloadFunc overload, ScriptRange<ScriptRange<ArgEnum>> overloadArg, ScriptProcData::parserFunc parser, ScriptProcData::argFunc arg, ScriptProcData::getFunc get)
+void ScriptParserBase::addParserBase(const std::string& s, const std::string& description, ScriptProcData::overloadFunc overload, ScriptRange<ScriptRange<ArgEnum>> overloadArg, ScriptProcData::parserFunc parser, ScriptProcData::argFunc arg, ScriptProcData::getFunc get, bool readOnly)
 {
 	if (haveNameRef(s))
 	{
@@ -2229,7 +2662,7 @@ void ScriptParserBase::addParserBase(const std::string& s, const std::string& de
 	{
 		overload = validOverloadProc(overloadArg) ? &overloadCustomProc : &overloadInvalidProc;
 	}
-	addSortHelper(_procList, { addNameRef(s), addNameRef(description), overload, overloadArg, parser, arg, get });
+	addSortHelper(_procList, { addNameRef(s), addNameRef(description), overload, overloadArg, parser, arg, get, readOnly });
 }
 
 /**
@@ -2489,6 +2922,8 @@ bool ScriptParserBase::parseBase(ScriptContainerBase& destScript, const std::str
 				Log(LOG_ERROR) << err << "script need to end with return statement";
 			}
 			help.relese();
+			tempScript._regUsed = help.regIndexUsed;
+			tempScript._profileId = ScriptProfiler::add(_name, parentName);
 			destScript = std::move(tempScript);
 			return true;
 		}
@@ -57,6 +57,19 @@ enum RegEnum : Uint16;
 enum RetEnum : Uint8;
 enum class ProgPos : size_t;
 
+/**
+ * What a script depends on besides its registers, from least to most.
+ */
+enum ScriptPurity : Uint8
+{
+	/// Only does arithmetic on its registers, same registers always give same result.
+	ScriptPure,
+	/// Also reads the objects its arguments point to.
+	ScriptReadOnly,
+	/// Can change objects, use RNG or write to log.
+	ScriptImpure,
+};
+
 //for ScriptBind.h
 struct BindBase;
 template<typename T> struct Bind;
@@ -81,6 +94,7 @@ struct ArgName
 constexpr size_t ScriptMaxOut = 9;
 constexpr size_t ScriptMaxArg = 16;
 constexpr size_t ScriptMaxReg = 64*sizeof(void*);
+constexpr int ScriptBatchMax = 32;
 
 ////////////////////////////////////////////////////////////
 //					script base types
@@ -373,7 +387,14 @@ struct TypeInfo
 class ScriptContainerBase
 {
 	friend struct ParserWriter;
+	friend class ScriptParserBase;
+	friend class ScriptWorkerBase;
 	std::vector<Uint8> _proc;
+	int _profileId = -1;
+	size_t _regUsed = 0;
+	Uint64 _regNamed = 0;
+	ScriptPurity _purity = ScriptPure;
+	mutable std::vector<Uint8> _memo;
 
 public:
 	/// Constructor.
@@ -402,6 +423,26 @@ public:
 	{
 		return *this ? _proc.data() : nullptr;
 	}
+	/// Get id of script in profiler.
+	int getProfileId() const
+	{
+		return _profileId;
+	}
+	/// Get what script depends on besides its registers.
+	ScriptPurity getPurity() const
+	{
+		return _purity;
+	}
+	/// Get size of registers used by script.
+	size_t getRegUsed() const
+	{
+		return _regUsed;
+	}
+	/// Does script name the argument or output value put in registers at this offset?
+	bool isRegNamed(size_t offset) const
+	{
+		return offset >= 64 || ((_regNamed >> offset) & 1);
+	}
 };
 
 /**
@@ -444,6 +485,11 @@ public:
 	{
 		return _current.data();
 	}
+	/// Get script of this container, without global events.
+	const ScriptContainerBase& current() const
+	{
+		return _current;
+	}
 	/// Get pointer to proc data.
 	const ScriptContainerBase* dataEvents() const
 	{
@@ -673,7 +719,20 @@ class ScriptWorkerBase
 		return offset<void, Args...>(sizeof...(Args), 0);
 	}
 
+	template<typename... Args, typename... OutputArgs>
+	static constexpr size_t offsetArgImpl(int i, helper::TypeTag<ScriptOutputArgs<OutputArgs...>> output)
+	{
+		return i < (int)sizeof...(OutputArgs) ? offset<void, OutputArgs...>(i, 0) : offset<void, Args...>(i - (int)sizeof...(OutputArgs), offsetOutput(output));
+	}
+
 protected:
+	/// Get offset of output value or argument, counting output values first.
+	template<typename Output, typename... Args>
+	static constexpr size_t offsetArg(int i)
+	{
+		return offsetArgImpl<Args...>(i, helper::TypeTag<Output>{});
+	}
+
 	/// Update values in script.
 	template<typename Output, typename... Args>
 	void updateBase(Args... args)
@@ -699,7 +758,18 @@ protected:
 	}
 
 	/// Call script.
-	void executeBase(const Uint8* proc);
+	void executeBase(const ScriptContainerBase& script);
+	/// Call script without timing benchmark section.
+	void executeScript(const ScriptContainerBase& script);
+	/// Call script without looking for remembered result.
+	void runScript(const ScriptContainerBase& script);
+	/// Call script for many workers at once.
+	static void executeBatch(ScriptWorkerBase* const* workers, int count, const ScriptContainerBase& script);
+	/// Copy registers used by scripts from other worker.
+	void copyRegs(const ScriptWorkerBase& other, size_t size)
+	{
+		memcpy(&reg, &other.reg, size);
+	}
 
 public:
 	/// Default constructor.
@@ -758,7 +828,7 @@ public:
 		static_assert(std::is_same<typename Parent::Output, Output>::value, "Incompatible script output type");
 
 		set(arg);
-		executeBase(c.data());
+		executeBase(c);
 		get(arg);
 	}
 
@@ -775,19 +845,19 @@ public:
 			while (*ptr)
 			{
 				reset(arg);
-				executeBase(ptr->data());
+				executeBase(*ptr);
 				++ptr;
 			}
 			++ptr;
 		}
 		reset(arg);
-		executeBase(c.data());
+		executeBase(c.current());
 		if (ptr)
 		{
 			while (*ptr)
 			{
 				reset(arg);
-				executeBase(ptr->data());
+				executeBase(*ptr);
 				++ptr;
 			}
 		}
@@ -801,15 +871,36 @@ public:
 class ScriptWorkerBlit : public ScriptWorkerBase
 {
 	/// Current script set in worker.
-	const Uint8* _proc;
+	const ScriptContainerBase* _proc;
 	const ScriptContainerBase* _events;
+	/// Output values and arguments named by the scripts, one bit each.
+	Uint32 _argsNamed;
+
+	/// Check if any script names the value in registers at this offset.
+	bool isRegNamed(size_t offset) const;
+	/// Get what the scripts depend on besides their registers.
+	ScriptPurity getPurity() const;
+
+	/// Update which output values and arguments are named by the scripts.
+	template<typename... Args>
+	void updateArgsNamed()
+	{
+		_argsNamed = 0;
+		for (int i = 0; i < 2 + (int)sizeof...(Args); ++i)
+		{
+			if (isRegNamed(offsetArg<Output, Args...>(i)))
+			{
+				_argsNamed |= 1u << i;
+			}
+		}
+	}
 
 public:
 	/// Type of output value from script.
 	using Output = ScriptOutputArgs<int&, int>;
 
 	/// Default constructor.
-	ScriptWorkerBlit() : ScriptWorkerBase(), _proc(nullptr), _events(nullptr)
+	ScriptWorkerBlit() : ScriptWorkerBase(), _proc(nullptr), _events(nullptr), _argsNamed(0)
 	{
 
 	}
@@ -822,9 +913,10 @@ public:
 		clear();
 		if (c)
 		{
-			_proc = c.data();
+			_proc = &c;
 			_events = nullptr;
 			updateBase<Output>(args...);
+			updateArgsNamed<helper::Decay<Args>...>();
 		}
 	}
 
@@ -836,12 +928,22 @@ public:
 		clear();
 		if (c)
 		{
-			_proc = c.data();
+			_proc = c.data() ? &c.current() : nullptr;
 			_events = c.dataEvents();
 			updateBase<Output>(args...);
+			updateArgsNamed<helper::Decay<Args>...>();
 		}
 	}
 
+	/// Is a script set, or is it a plain blit?
+	bool haveScript() const { return _proc != nullptr; }
+	/// Can the colors given by the scripts be remembered during one blit?
+	bool canMemoBlit(size_t& regUsed) const;
+	/// Does any script name the output value or argument, counting output values first?
+	bool isArgNamed(int i) const { return (_argsNamed >> i) & 1; }
+	/// Can the result of the scripts be blitted again, on another background and in another frame?
+	bool canReuseBlit() const;
+
 	/// Programmable blitting using script.
 	void executeBlit(Surface* src, Surface* dest, int x, int y, int shade);
 	/// Programmable blitting using script.
@@ -852,6 +954,7 @@ public:
 	{
 		_proc = nullptr;
 		_events = nullptr;
+		_argsNamed = 0;
 	}
 };
 
@@ -1128,6 +1231,7 @@ struct ScriptProcData
 	parserFunc parser;
 	argFunc parserArg;
 	getFunc parserGet;
+	bool readOnly;
 
 	bool operator()(ParserWriter& ph, const ScriptRefData* begin, const ScriptRefData* end) const
 	{
@@ -1212,7 +1316,7 @@ protected:
 	/// Add name for custom parameter.
 	void addScriptReg(const std::string& s, ArgEnum type, bool writableReg, bool outputReg);
 	/// Add parsing function.
-	void addParserBase(const std::string& s, const std::string& description, ScriptProcData::overloadFunc overload, ScriptRange<ScriptRange<ArgEnum>> overloadArg, ScriptProcData::parserFunc parser, ScriptProcData::argFunc parserArg, ScriptProcData::getFunc parserGet);
+	void addParserBase(const std::string& s, const std::string& description, ScriptProcData::overloadFunc overload, ScriptRange<ScriptRange<ArgEnum>> overloadArg, ScriptProcData::parserFunc parser, ScriptProcData::argFunc parserArg, ScriptProcData::getFunc parserGet, bool readOnly = false);
 	/// Add new type implementation.
 	void addTypeBase(const std::string& s, ArgEnum type, TypeInfo meta);
 	/// Test if type was added implementation.
@@ -1246,7 +1350,7 @@ public:
 	template<typename T>
 	void addParser(const std::string& s, const std::string& description)
 	{
-		addParserBase(s, description, nullptr, T::overloadType(), nullptr, &T::parse, &T::getDynamic);
+		addParserBase(s, description, nullptr, T::overloadType(), nullptr, &T::parse, &T::getDynamic, T::readOnly());
 	}
 	/// Test if type was already added.
 	template<typename T>
@@ -201,6 +201,9 @@ struct ParserWriter
 	/// Updating previously added proc operation id.
 	void updateProc(ReservedPos<ProcOp> pos, int procOffset);
 
+	/// Lower what is known about side effects of script.
+	void updatePurity(ScriptPurity purity);
+
 	/// Try pushing label arg on proc vector. Can't use this to create loop back label.
 	bool pushLabelTry(const ScriptRefData& data);
 
@@ -845,6 +848,42 @@ struct GetArgsImpl<RetEnum(Args...)>
 template<typename Func>
 using GetArgs = typename GetArgsImpl<decltype(Func::func)>::type;
 
+/**
+ * Can a function argument of this type be used to change anything
+ * outside of script registers? Registers are passed by reference,
+ * so only pointers to non-const objects (that include RNG state)
+ * and the worker itself (used to write to log) count.
+ */
+template<typename T>
+struct IsReadOnlyArg : std::true_type
+{
+
+};
+
+template<typename T>
+struct IsReadOnlyArg<T*> : std::is_const<T>
+{
+
+};
+
+template<>
+struct IsReadOnlyArg<ScriptWorkerBase&> : std::false_type
+{
+
+};
+
+template<typename T>
+struct IsReadOnlyFuncImpl;
+
+template<typename... Args>
+struct IsReadOnlyFuncImpl<RetEnum(Args...)> : std::bool_constant<(IsReadOnlyArg<Args>::value && ...)>
+{
+
+};
+
+template<typename Func>
+using IsReadOnlyFunc = IsReadOnlyFuncImpl<decltype(Func::func)>;
+
 ////////////////////////////////////////////////////////////
 //				FuncVer and FuncGroup class
 ////////////////////////////////////////////////////////////
@@ -889,6 +928,7 @@ struct FuncGroup<Func, ListTag<Ver...>> : GetArgs<Func>
 	using GetArgs<Func>::overloadType;
 
 	static constexpr ScriptFunc getDynamic(int i) { return FuncList::getDynamic(i); }
+	static constexpr bool readOnly() { return IsReadOnlyFunc<Func>::value; }
 };
 
 ////////////////////////////////////////////////////////////
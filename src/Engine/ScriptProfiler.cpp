@@ -0,0 +1,257 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ScriptProfiler.h"
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include "CrossPlatform.h"
+#include "Logger.h"
+
+namespace OpenXcom
+{
+
+namespace ScriptProfiler
+{
+
+/// Number of the slowest scripts listed in the report.
+const size_t REPORT_SCRIPTS = 20;
+
+bool enabled = false;
+
+namespace
+{
+std::vector<ScriptProfileEntry> entries;
+std::string currentMod;
+std::string flameGraphFile;
+
+/**
+ * Adds up entries that share a key.
+ */
+struct ProfileTotal
+{
+	uint64_t calls = 0, ops = 0, nanoseconds = 0;
+};
+
+/**
+ * Writes one table of the report, slowest first.
+ * @param title Name of the first column.
+ * @param rows Totals by name.
+ * @param limit Maximum number of rows.
+ */
+void reportTable(const std::string &title, const std::vector<std::pair<std::string, ProfileTotal>> &rows, size_t limit)
+{
+	std::vector<std::pair<std::string, ProfileTotal>> sorted = rows;
+	std::stable_sort(sorted.begin(), sorted.end(), [](const std::pair<std::string, ProfileTotal> &a, const std::pair<std::string, ProfileTotal> &b) { return a.second.nanoseconds > b.second.nanoseconds; });
+
+	std::ostringstream header;
+	header << std::left << std::setw(48) << title << std::right << std::setw(12) << "calls" << std::setw(14) << "ops" << std::setw(14) << "total ms" << std::setw(12) << "avg us" << std::setw(10) << "ops/call";
+	Log(LOG_INFO) << header.str();
+	for (size_t i = 0; i < sorted.size() && i < limit; ++i)
+	{
+		const ProfileTotal &t = sorted[i].second;
+		if (t.calls == 0)
+		{
+			break;
+		}
+		std::ostringstream line;
+		line << std::left << std::setw(48) << sorted[i].first << std::right << std::setw(12) << t.calls << std::setw(14) << t.ops;
+		line << std::fixed << std::setprecision(3) << std::setw(14) << t.nanoseconds / 1e6 << std::setw(12) << t.nanoseconds / 1e3 / t.calls;
+		line << std::setprecision(1) << std::setw(10) << (double)t.ops / t.calls;
+		Log(LOG_INFO) << line.str();
+	}
+}
+
+/**
+ * Adds up the entries by some key, keeping the order keys first appear in.
+ * @param key Function giving the key of an entry.
+ * @return Totals by key.
+ */
+template<typename F>
+std::vector<std::pair<std::string, ProfileTotal>> sumBy(F key)
+{
+	std::vector<std::pair<std::string, ProfileTotal>> rows;
+	std::map<std::string, size_t> index;
+	for (const auto &e : entries)
+	{
+		std::string k = key(e);
+		auto i = index.find(k);
+		if (i == index.end())
+		{
+			i = index.insert(std::make_pair(k, rows.size())).first;
+			rows.push_back(std::make_pair(k, ProfileTotal()));
+		}
+		ProfileTotal &t = rows[i->second].second;
+		t.calls += e.calls;
+		t.ops += e.ops;
+		t.nanoseconds += e.nanoseconds;
+	}
+	return rows;
+}
+
+/**
+ * Makes a name usable as a flame graph frame.
+ * @param name Hook, mod or rule name.
+ * @return Name without separators.
+ */
+std::string frameName(const std::string &name)
+{
+	std::string frame = name.empty() ? "-" : name;
+	std::replace(frame.begin(), frame.end(), ';', '_');
+	std::replace(frame.begin(), frame.end(), ' ', '_');
+	return frame;
+}
+}
+
+/**
+ * Sets the mod the scripts compiled from now on come from.
+ * @param mod Mod id, empty outside of mod loading.
+ */
+void setCurrentMod(const std::string &mod)
+{
+	currentMod = mod;
+}
+
+/**
+ * Registers a freshly compiled script. Ids are never reused,
+ * so scripts of a previous mod load just stay at zero.
+ * @param hook Name of the script parser, eg. recolorUnitSprite.
+ * @param rule Rule the script belongs to.
+ * @return Id the script runs are recorded with.
+ */
+int add(const std::string &hook, const std::string &rule)
+{
+	entries.push_back(ScriptProfileEntry(hook, currentMod, rule));
+	return (int)entries.size() - 1;
+}
+
+/**
+ * Adds one run of a script.
+ * @param id Script id.
+ * @param ops Number of operations executed.
+ * @param nanoseconds Time the run took.
+ */
+void record(int id, uint64_t ops, uint64_t nanoseconds)
+{
+	if (id < 0 || id >= (int)entries.size())
+	{
+		return;
+	}
+	ScriptProfileEntry &e = entries[id];
+	e.calls++;
+	e.ops += ops;
+	e.nanoseconds += nanoseconds;
+}
+
+/**
+ * Clears the counters and starts profiling.
+ * @param flameGraphPath File to write the folded stacks to, empty for none.
+ */
+void start(const std::string &flameGraphPath)
+{
+	for (auto &e : entries)
+	{
+		e.calls = 0;
+		e.ops = 0;
+		e.nanoseconds = 0;
+	}
+	flameGraphFile = flameGraphPath;
+	enabled = true;
+	Log(LOG_INFO) << "Script profiling started.";
+}
+
+/**
+ * Stops profiling and reports the results.
+ */
+void stop()
+{
+	if (!enabled)
+	{
+		return;
+	}
+	enabled = false;
+	report();
+}
+
+/**
+ * Gets the counters of every script registered so far.
+ * @return Counters by script id.
+ */
+const std::vector<ScriptProfileEntry> &getEntries()
+{
+	return entries;
+}
+
+/**
+ * Writes the time spent in scripts by hook, by mod, and for
+ * the slowest scripts, to the log. Also writes the flame graph
+ * file if one was asked for.
+ */
+void report()
+{
+	ProfileTotal total;
+	for (const auto &e : entries)
+	{
+		total.calls += e.calls;
+		total.nanoseconds += e.nanoseconds;
+	}
+	Log(LOG_INFO) << "Script profile: " << total.calls << " runs, " << std::fixed << std::setprecision(3) << total.nanoseconds / 1e6 << " ms";
+	if (total.calls == 0)
+	{
+		return;
+	}
+	reportTable("hook", sumBy([](const ScriptProfileEntry &e) { return e.hook; }), entries.size());
+	reportTable("mod", sumBy([](const ScriptProfileEntry &e) { return e.mod; }), entries.size());
+	reportTable("script (hook / mod / rule)", sumBy([](const ScriptProfileEntry &e) { return e.hook + " / " + e.mod + " / " + e.rule; }), REPORT_SCRIPTS);
+
+	if (!flameGraphFile.empty())
+	{
+		writeFlameGraph(flameGraphFile);
+	}
+}
+
+/**
+ * Writes the time spent in every script as "mod;hook;rule microseconds"
+ * lines, the folded stack format read by flamegraph.pl and speedscope.
+ * @param path File to write.
+ * @return True if it was written.
+ */
+bool writeFlameGraph(const std::string &path)
+{
+	std::ostringstream ss;
+	for (const auto &e : entries)
+	{
+		if (e.calls == 0)
+		{
+			continue;
+		}
+		ss << frameName(e.mod) << ';' << frameName(e.hook) << ';' << frameName(e.rule) << ' ' << std::max<uint64_t>(e.nanoseconds / 1000, 1) << '\n';
+	}
+	if (!CrossPlatform::writeFile(path, ss.str()))
+	{
+		Log(LOG_ERROR) << "Failed to write script profile to " << path;
+		return false;
+	}
+	Log(LOG_INFO) << "Script profile written to " << path;
+	return true;
+}
+
+}
+
+}
@@ -0,0 +1,69 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace OpenXcom
+{
+
+/**
+ * What one compiled script cost since profiling started.
+ */
+struct ScriptProfileEntry
+{
+	std::string hook, mod, rule;
+	uint64_t calls = 0;
+	uint64_t ops = 0;
+	uint64_t nanoseconds = 0;
+
+	ScriptProfileEntry(const std::string &h, const std::string &m, const std::string &r) : hook(h), mod(m), rule(r) { }
+};
+
+/**
+ * Opt-in counters of how often each mod script runs, how many
+ * operations it executes and how long it takes, so a slow mod
+ * can be traced to the hook and rule of the script responsible.
+ * Every script is registered when it's compiled, and only costs
+ * a single check per run while profiling is off.
+ */
+namespace ScriptProfiler
+{
+	/// Are the scripts being profiled?
+	extern bool enabled;
+	/// Sets the mod that scripts compiled from now on belong to.
+	void setCurrentMod(const std::string &mod);
+	/// Registers a compiled script and gets its id.
+	int add(const std::string &hook, const std::string &rule);
+	/// Adds one run of a script.
+	void record(int id, uint64_t ops, uint64_t nanoseconds);
+	/// Starts profiling, writing the flame graph file to the given path on every report.
+	void start(const std::string &flameGraphPath);
+	/// Stops profiling, reporting what was measured.
+	void stop();
+	/// Gets the counters of every registered script.
+	const std::vector<ScriptProfileEntry> &getEntries();
+	/// Writes the totals per hook, per mod and the slowest scripts to the log.
+	void report();
+	/// Writes the counters as folded stacks for flame graph tools.
+	bool writeFlameGraph(const std::string &path);
+}
+
+}
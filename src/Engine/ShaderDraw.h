@@ -31,12 +31,12 @@ static inline First&& GetFirst(First&& f, Rest&&... r)
 }
 
 /**
- * Universal blit function implementation.
- * @param f called function.
+ * Iterates over the rows of the common part of all surfaces.
+ * @param row called for every row with its length, after the surface controls are set on its first pixel.
  * @param src source surfaces control objects.
  */
-template<typename Func, typename... SrcType>
-static inline void ShaderDrawImpl(Func&& f, helper::controler<SrcType>... src)
+template<typename RowFunc, typename... SrcType>
+static inline void ShaderDrawRowsImpl(RowFunc&& row, helper::controler<SrcType>&... src)
 {
 	//get basic draw range in 2d space
 	GraphSubset end_temp = GetFirst(src...).get_range();
@@ -77,26 +77,41 @@ static inline void ShaderDrawImpl(Func&& f, helper::controler<SrcType>... src)
 		//set final iteration range
 		(src.set_x(begin_x, end_x), ...);
 
-		int size_x = end_x-begin_x;
-		//iteration on x-axis
-		for (int x = size_x / 4; x>0; --x)
-		{
-			f(src.get_ref()...); (src.inc_x(), ...);
-			f(src.get_ref()...); (src.inc_x(), ...);
-			f(src.get_ref()...); (src.inc_x(), ...);
-			f(src.get_ref()...); (src.inc_x(), ...);
-		}
-		if (size_x & 2)
-		{
-			f(src.get_ref()...); (src.inc_x(), ...);
-			f(src.get_ref()...); (src.inc_x(), ...);
-		}
-		if (size_x & 1)
-		{
-			f(src.get_ref()...); (src.inc_x(), ...);
-		}
+		row(end_x-begin_x);
 	}
+}
 
+/**
+ * Universal blit function implementation.
+ * @param f called function.
+ * @param src source surfaces control objects.
+ */
+template<typename Func, typename... SrcType>
+static inline void ShaderDrawImpl(Func&& f, helper::controler<SrcType>... src)
+{
+	ShaderDrawRowsImpl(
+		[&](int size_x)
+		{
+			//iteration on x-axis
+			for (int x = size_x / 4; x>0; --x)
+			{
+				f(src.get_ref()...); (src.inc_x(), ...);
+				f(src.get_ref()...); (src.inc_x(), ...);
+				f(src.get_ref()...); (src.inc_x(), ...);
+				f(src.get_ref()...); (src.inc_x(), ...);
+			}
+			if (size_x & 2)
+			{
+				f(src.get_ref()...); (src.inc_x(), ...);
+				f(src.get_ref()...); (src.inc_x(), ...);
+			}
+			if (size_x & 1)
+			{
+				f(src.get_ref()...); (src.inc_x(), ...);
+			}
+		},
+		src...
+	);
 };
 
 /**
@@ -122,6 +137,23 @@ static inline void ShaderDrawFunc(Func&& f, const SrcType&... src_frame)
 	ShaderDrawImpl(std::forward<Func>(f), helper::controler<SrcType>(src_frame)...);
 }
 
+/**
+ * Universal blit function working on whole rows.
+ * Surfaces must have consecutive pixels in a row (ie. no ShaderCrop with a step).
+ * @param f function that gets the length of the row followed by references
+ * to the first pixel of the row of every surface, or to the scalars.
+ * @param src_frame destination and source surfaces modified by function.
+ */
+template<typename Func, typename... SrcType>
+static inline void ShaderDrawRows(Func&& f, const SrcType&... src_frame)
+{
+	auto rows = [&f](helper::controler<SrcType>... src)
+	{
+		ShaderDrawRowsImpl([&](int size_x) { f(size_x, src.get_ref()...); }, src...);
+	};
+	rows(helper::controler<SrcType>(src_frame)...);
+}
+
 namespace helper
 {
 
@@ -18,6 +18,7 @@
  */
 #include "Surface.h"
 #include "ShaderDraw.h"
+#include "BlitKernels.h"
 #include "ShaderMove.h"
 #include <vector>
 #include <algorithm>
@@ -953,11 +954,23 @@ void Surface::blitRaw(SurfaceRaw<Uint8> destSurf, SurfaceRaw<const Uint8> srcSur
 	{
 		--newBaseColor;
 		newBaseColor <<= 4;
-		ShaderDraw<helper::ColorReplace>(ShaderSurface(destSurf), src, ShaderScalar(shade), ShaderScalar(newBaseColor));
+		ShaderDrawRows(
+			[](int count, Uint8& destPixel, const Uint8& srcPixel, const int& shade, const int& newColor)
+			{
+				BlitKernels::replaceRow(&destPixel, &srcPixel, count, shade, newColor);
+			},
+			ShaderSurface(destSurf), src, ShaderScalar(shade), ShaderScalar(newBaseColor)
+		);
 	}
 	else
 	{
-		ShaderDraw<helper::StandardShade>(ShaderSurface(destSurf), src, ShaderScalar(shade));
+		ShaderDrawRows(
+			[](int count, Uint8& destPixel, const Uint8& srcPixel, const int& shade)
+			{
+				BlitKernels::shadeRow(&destPixel, &srcPixel, count, shade);
+			},
+			ShaderSurface(destSurf), src, ShaderScalar(shade)
+		);
 	}
 }
 
@@ -992,7 +1005,13 @@ void Surface::blitNShade(SurfaceRaw<Uint8> surface, int x, int y, int shade, Gra
 
 	dest.setDomain(range);
 
-	ShaderDraw<helper::StandardShade>(dest, src, ShaderScalar(shade));
+	ShaderDrawRows(
+		[](int count, Uint8& destPixel, const Uint8& srcPixel, const int& shade)
+		{
+			BlitKernels::shadeRow(&destPixel, &srcPixel, count, shade);
+		},
+		dest, src, ShaderScalar(shade)
+	);
 }
 
 /**
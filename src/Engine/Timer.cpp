@@ -17,6 +17,8 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "Timer.h"
+#include <algorithm>
+#include <cstdint>
 #include "Game.h"
 #include "Options.h"
 
@@ -41,6 +43,8 @@ Uint32 slowTick()
 
 Uint32 Timer::gameSlowSpeed = 1;
 int Timer::maxFrameSkip = 8; // this is a pretty good default at 60FPS.
+bool Timer::_fired = false;
+Uint32 Timer::_nextDue = UINT32_MAX;
 
 
 /**
@@ -133,10 +137,49 @@ void Timer::think(State* state, Surface* surface)
 			}
 			_start = slowTick();
 			if (_start > _frameSkipStart) _frameSkipStart = _start; // don't play animations in ffwd to catch up :P
+			_fired = true;
+		}
+		if (_running)
+		{
+			// the handlers may have stopped the timer
+			Sint64 left = (Sint64)_frameSkipStart + _interval - slowTick();
+			Uint32 due = left > 0 ? (Uint32)(left * gameSlowSpeed) : 0;
+			_nextDue = std::min(_nextDue, due);
 		}
 	}
 }
 
+/**
+ * Forgets which timers ran so far, so the game loop can
+ * find out what the next pass of timers does.
+ */
+void Timer::beginPass()
+{
+	_fired = false;
+	_nextDue = UINT32_MAX;
+}
+
+/**
+ * Checks if any timer called its handlers since beginPass(),
+ * which usually means something on screen changed.
+ * @return True if a timer fired.
+ */
+bool Timer::hasFired()
+{
+	return _fired;
+}
+
+/**
+ * Gets how long until the earliest of the timers that were
+ * advanced since beginPass() fires again, so the game loop
+ * can sleep until then.
+ * @return Time in milliseconds, UINT32_MAX if no timer is running.
+ */
+Uint32 Timer::getTimeUntilNext()
+{
+	return _nextDue;
+}
+
 /**
  * Changes the timer's interval to a new value.
  * @param interval Interval in milliseconds.
@@ -39,6 +39,8 @@ public:
 	static Uint32 gameSlowSpeed;
 
 private:
+	static bool _fired;
+	static Uint32 _nextDue;
 	Uint32 _start;
 	Uint32 _frameSkipStart;
 	int _interval;
@@ -69,6 +71,12 @@ public:
 	void onTimer(SurfaceHandler handler);
 	/// Turns frame skipping on or off
 	void setFrameSkipping(bool skip);
+	/// Starts collecting what the timers do during a pass of the game loop.
+	static void beginPass();
+	/// Checks if any timer called its handlers during this pass.
+	static bool hasFired();
+	/// Gets the time until the earliest timer that ran this pass is due again.
+	static Uint32 getTimeUntilNext();
 };
 
 }
@@ -0,0 +1,216 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "WorkerPool.h"
+#include <algorithm>
+#include <thread>
+#include "Logger.h"
+#include "Options.h"
+
+namespace OpenXcom
+{
+
+WorkerPool *WorkerPool::_shared = 0;
+
+/**
+ * Starts the background threads. The thread calling run()
+ * also runs jobs, so one less thread is created.
+ * @param threads Number of threads that run jobs, at least 1.
+ */
+WorkerPool::WorkerPool(int threads) : _job(0), _next(0), _count(0), _finished(0), _quit(false)
+{
+	_mutex = SDL_CreateMutex();
+	_wake = SDL_CreateCond();
+	_done = SDL_CreateCond();
+	if (_mutex == 0 || _wake == 0 || _done == 0)
+	{
+		Log(LOG_WARNING) << "Can't create worker threads: " << SDL_GetError();
+		return;
+	}
+	for (int i = 1; i < threads; ++i)
+	{
+		SDL_Thread *thread = SDL_CreateThread(worker, this);
+		if (thread == 0)
+		{
+			Log(LOG_WARNING) << "Can't create worker thread: " << SDL_GetError();
+			break;
+		}
+		_threads.push_back(thread);
+	}
+}
+
+/**
+ * Wakes up the background threads so they can quit,
+ * and waits for them.
+ */
+WorkerPool::~WorkerPool()
+{
+	if (_mutex != 0)
+	{
+		SDL_LockMutex(_mutex);
+		_quit = true;
+		SDL_CondBroadcast(_wake);
+		SDL_UnlockMutex(_mutex);
+	}
+	for (auto *thread : _threads)
+	{
+		SDL_WaitThread(thread, 0);
+	}
+	if (_done != 0)
+		SDL_DestroyCond(_done);
+	if (_wake != 0)
+		SDL_DestroyCond(_wake);
+	if (_mutex != 0)
+		SDL_DestroyMutex(_mutex);
+}
+
+/**
+ * Waits for jobs until the pool is destroyed.
+ * @param pool Pointer to the pool.
+ * @return Thread exit code.
+ */
+int WorkerPool::worker(void *pool)
+{
+	WorkerPool *self = (WorkerPool*)pool;
+	SDL_LockMutex(self->_mutex);
+	while (true)
+	{
+		while (!self->_quit && self->_next >= self->_count)
+		{
+			SDL_CondWait(self->_wake, self->_mutex);
+		}
+		if (self->_quit)
+		{
+			break;
+		}
+		SDL_UnlockMutex(self->_mutex);
+		self->work();
+		SDL_LockMutex(self->_mutex);
+	}
+	SDL_UnlockMutex(self->_mutex);
+	return 0;
+}
+
+/**
+ * Takes the next job and runs it, until every job
+ * of the current run has been taken.
+ */
+void WorkerPool::work()
+{
+	while (true)
+	{
+		SDL_LockMutex(_mutex);
+		if (_next >= _count)
+		{
+			SDL_UnlockMutex(_mutex);
+			return;
+		}
+		int job = _next++;
+		SDL_UnlockMutex(_mutex);
+
+		(*_job)(job);
+
+		SDL_LockMutex(_mutex);
+		if (++_finished == _count)
+		{
+			SDL_CondSignal(_done);
+		}
+		SDL_UnlockMutex(_mutex);
+	}
+}
+
+/**
+ * Gets the number of threads that run jobs,
+ * including the one calling run().
+ * @return Number of threads.
+ */
+int WorkerPool::getThreads() const
+{
+	return (int)_threads.size() + 1;
+}
+
+/**
+ * Runs every job once, spread over the threads of the pool,
+ * and returns when they are all done. Jobs must not touch
+ * the same data, and are run in no particular order.
+ * @param count Number of jobs.
+ * @param job Function called with the number of each job.
+ */
+void WorkerPool::run(int count, const std::function<void(int)> &job)
+{
+	if (_threads.empty() || count < 2)
+	{
+		for (int i = 0; i < count; ++i)
+		{
+			job(i);
+		}
+		return;
+	}
+
+	SDL_LockMutex(_mutex);
+	_job = &job;
+	_next = 0;
+	_finished = 0;
+	_count = count;
+	SDL_CondBroadcast(_wake);
+	SDL_UnlockMutex(_mutex);
+
+	work();
+
+	SDL_LockMutex(_mutex);
+	while (_finished < _count)
+	{
+		SDL_CondWait(_done, _mutex);
+	}
+	_job = 0;
+	_next = 0;
+	_count = 0;
+	SDL_UnlockMutex(_mutex);
+}
+
+/**
+ * Gets the pool shared by the engine, creating it on first use
+ * with as many threads as the workerThreads option asks for,
+ * or one per CPU core if it's 0.
+ * @return Shared pool.
+ */
+WorkerPool *WorkerPool::getShared()
+{
+	if (_shared == 0)
+	{
+		int threads = Options::workerThreads;
+		if (threads <= 0)
+		{
+			threads = std::min((int)std::thread::hardware_concurrency(), 8);
+		}
+		_shared = new WorkerPool(std::max(threads, 1));
+		Log(LOG_INFO) << "Worker pool started with " << _shared->getThreads() << " threads.";
+	}
+	return _shared;
+}
+
+/**
+ * Stops the pool shared by the engine, if it was ever used.
+ */
+void WorkerPool::shutdownShared()
+{
+	delete _shared;
+	_shared = 0;
+}
+
+}
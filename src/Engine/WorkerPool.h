@@ -0,0 +1,65 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <functional>
+#include <vector>
+#include <SDL_thread.h>
+
+namespace OpenXcom
+{
+
+/**
+ * A fixed set of background threads that run numbered
+ * jobs in parallel, with the calling thread helping out.
+ * Meant for splitting per-frame work like image filters
+ * into independent parts, not for game logic.
+ */
+class WorkerPool
+{
+private:
+	static WorkerPool *_shared;
+	std::vector<SDL_Thread*> _threads;
+	SDL_mutex *_mutex;
+	SDL_cond *_wake, *_done;
+	const std::function<void(int)> *_job;
+	int _next, _count, _finished;
+	bool _quit;
+
+	/// Entry point of the background threads.
+	static int worker(void *pool);
+	/// Runs jobs until there are none left to take.
+	void work();
+public:
+	/// Creates a pool with the given number of threads.
+	WorkerPool(int threads);
+	/// Stops the threads of the pool.
+	~WorkerPool();
+	WorkerPool(const WorkerPool&) = delete;
+	WorkerPool &operator=(const WorkerPool&) = delete;
+	/// Gets the number of threads that run jobs.
+	int getThreads() const;
+	/// Runs jobs 0 to count-1 and waits for all of them.
+	void run(int count, const std::function<void(int)> &job);
+	/// Gets the pool shared by the engine.
+	static WorkerPool *getShared();
+	/// Stops the pool shared by the engine.
+	static void shutdownShared();
+};
+
+}
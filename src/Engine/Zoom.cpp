@@ -25,6 +25,7 @@
 #include "Screen.h"
 
 #include "OpenGL.h"
+#include "ParallelScaler.h"
 
 // Scale2X
 #include "Scalers/scalebit.h"
@@ -647,6 +648,21 @@ bool Zoom::haveSSE2()
 
 #endif
 
+/**
+ * Fills the color lookup table of the hqx filters,
+ * the first time it is called.
+ */
+void Zoom::initHQX()
+{
+	static bool initDone = false;
+
+	if (!initDone)
+	{
+		hqxInit();
+		initDone = true;
+	}
+}
+
 /**
  * Wrapper around various software and OpenGL screen buffer pushing functions which zoom.
  * Basically called just from Screen::flip()
@@ -658,8 +674,9 @@ bool Zoom::haveSSE2()
  * @param leftBlackBand Size of left black band in pixels (letterboxing).
  * @param rightBlackBand Size of right black band in pixels (letterboxing).
  * @param glOut OpenGL output.
+ * @param scaler Runs the 32-bit filters in parallel and keeps the letterboxing buffer.
  */
-void Zoom::flipWithZoom(SDL_Surface *src, SDL_Surface *dst, int topBlackBand, int bottomBlackBand, int leftBlackBand, int rightBlackBand, OpenGL *glOut)
+void Zoom::flipWithZoom(SDL_Surface *src, SDL_Surface *dst, int topBlackBand, int bottomBlackBand, int leftBlackBand, int rightBlackBand, OpenGL *glOut, ParallelScaler *scaler)
 {
 	int dstWidth = dst->w - leftBlackBand - rightBlackBand;
 	int dstHeight = dst->h - topBlackBand - bottomBlackBand;
@@ -677,7 +694,10 @@ void Zoom::flipWithZoom(SDL_Surface *src, SDL_Surface *dst, int topBlackBand, in
 	}
 	else if (topBlackBand <= 0 && bottomBlackBand <= 0 && leftBlackBand <= 0 && rightBlackBand <= 0)
 	{
-		_zoomSurfaceY(src, dst, 0, 0);
+		if (!scaler->scale(src, dst))
+		{
+			_zoomSurfaceY(src, dst, 0, 0);
+		}
 	}
 	else if (dstWidth == src->w && dstHeight == src->h)
 	{
@@ -686,15 +706,17 @@ void Zoom::flipWithZoom(SDL_Surface *src, SDL_Surface *dst, int topBlackBand, in
 	}
 	else
 	{
-		SDL_Surface *tmp = SDL_CreateRGBSurface(dst->flags, dstWidth, dstHeight, dst->format->BitsPerPixel, 0, 0, 0, 0);
-		_zoomSurfaceY(src, tmp, 0, 0);
+		SDL_Surface *tmp = scaler->getBuffer(dst, dstWidth, dstHeight);
+		if (!scaler->scale(src, tmp))
+		{
+			_zoomSurfaceY(src, tmp, 0, 0);
+		}
 		if (src->format->palette != NULL)
 		{
 			SDL_SetPalette(tmp, SDL_LOGPAL|SDL_PHYSPAL, src->format->palette->colors, 0, src->format->palette->ncolors);
 		}
 		SDL_Rect dstrect = {(Sint16)leftBlackBand, (Sint16)topBlackBand, (Uint16)tmp->w, (Uint16)tmp->h};
 		SDL_BlitSurface(tmp, NULL, dst, &dstrect);
-		SDL_FreeSurface(tmp);
 	}
 }
 
@@ -740,13 +762,7 @@ int Zoom::_zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int fli
 
 		if (Options::useHQXFilter)
 		{
-			static bool initDone = false;
-
-			if (!initDone)
-			{
-				hqxInit();
-				initDone = true;
-			}
+			initHQX();
 
 			// HQX_API void HQX_CALLCONV hq2x_32_rb( uint32_t * src, uint32_t src_rowBytes, uint32_t * dest, uint32_t dest_rowBytes, int width, int height );
 
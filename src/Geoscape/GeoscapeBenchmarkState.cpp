@@ -0,0 +1,217 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "GeoscapeBenchmarkState.h"
+#include <yaml-cpp/yaml.h>
+#include "GeoscapeState.h"
+#include "../Engine/Game.h"
+#include "../Engine/Exception.h"
+#include "../Engine/Logger.h"
+#include "../Engine/Options.h"
+#include "../Engine/RNG.h"
+#include "../Engine/Screen.h"
+#include "../Savegame/GameTime.h"
+#include "../Savegame/SavedGame.h"
+#include "../fallthrough.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Initializes the benchmark.
+ * @param filename Save filename, relative to the master user folder.
+ * @param days Number of days to simulate.
+ * @param seed RNG seed to run with, 0 to keep the one in the save.
+ */
+GeoscapeBenchmarkState::GeoscapeBenchmarkState(const std::string &filename, int days, uint64_t seed) : _filename(filename), _days(days), _day(-1), _seed(seed), _geo(0)
+{
+	const char *names[SECTION_COUNT] = { "time5Seconds", "time10Minutes", "time30Minutes", "time1Hour", "time1Day", "time1Month", "idle steps", "whole day" };
+	for (int i = 0; i < SECTION_COUNT; ++i)
+	{
+		_counters.push_back(BenchmarkCounter(names[i]));
+	}
+}
+
+/**
+ *
+ */
+GeoscapeBenchmarkState::~GeoscapeBenchmarkState()
+{
+	delete _geo;
+}
+
+/**
+ * Loads the saved game and sets up the geoscape logic to run on it.
+ * @return True if the save could be used.
+ */
+bool GeoscapeBenchmarkState::load()
+{
+	SavedGame *save = new SavedGame();
+	try
+	{
+		save->load(_filename, _game->getMod(), _game->getLanguage());
+	}
+	catch (Exception &e)
+	{
+		Log(LOG_ERROR) << "Geoscape benchmark: can't load " << _filename << ": " << e.what();
+		delete save;
+		return false;
+	}
+	catch (YAML::Exception &e)
+	{
+		Log(LOG_ERROR) << "Geoscape benchmark: can't load " << _filename << ": " << e.what();
+		delete save;
+		return false;
+	}
+	if (save->getSavedBattle() != 0 || save->getEnding() != END_NONE)
+	{
+		Log(LOG_ERROR) << "Geoscape benchmark: " << _filename << " is not a geoscape save.";
+		delete save;
+		return false;
+	}
+
+	// never let the run overwrite the player's saves
+	save->setIronman(false);
+	_game->setSavedGame(save);
+	Options::baseXResolution = Options::baseXGeoscape;
+	Options::baseYResolution = Options::baseYGeoscape;
+	_game->getScreen()->resetDisplay(false);
+	if (_seed != 0)
+	{
+		RNG::setSeed(_seed);
+	}
+	Log(LOG_INFO) << "Geoscape benchmark: " << _filename << ", " << _days << " days at 1 Day speed, seed " << RNG::getSeed();
+	_geo = new GeoscapeState;
+	return true;
+}
+
+/**
+ * Advances the game time by one day in 5 second steps, the same way
+ * GeoscapeState::timeAdvance() does at the 1 Day speed, timing every
+ * trigger. Anything that would stop the time for the player is thrown
+ * away, and so is any slowdown of the timer it asked for.
+ */
+void GeoscapeBenchmarkState::runDay()
+{
+	BenchmarkScope day(_counters[SECTION_DAY]);
+	SavedGame *save = _game->getSavedGame();
+	const int steps = 24 * 60 * 12;
+	for (int i = 0; i < steps && save->getEnding() == END_NONE; ++i)
+	{
+		// some logic depends on the speed, eg. the fast hunter-killer retargeting
+		_geo->timerFastest();
+		switch (save->getTime()->advance())
+		{
+		case TIME_1MONTH:
+			{
+				BenchmarkScope scope(_counters[SECTION_1MONTH]);
+				_geo->time1Month();
+			}
+			FALLTHROUGH;
+		case TIME_1DAY:
+			{
+				BenchmarkScope scope(_counters[SECTION_1DAY]);
+				_geo->time1Day();
+			}
+			FALLTHROUGH;
+		case TIME_1HOUR:
+			{
+				BenchmarkScope scope(_counters[SECTION_1HOUR]);
+				_geo->time1Hour();
+			}
+			FALLTHROUGH;
+		case TIME_30MIN:
+			{
+				BenchmarkScope scope(_counters[SECTION_30MIN]);
+				_geo->time30Minutes();
+			}
+			FALLTHROUGH;
+		case TIME_10MIN:
+			{
+				BenchmarkScope scope(_counters[SECTION_10MIN]);
+				_geo->time10Minutes();
+			}
+			FALLTHROUGH;
+		case TIME_5SEC:
+			{
+				BenchmarkScope scope(_counters[SECTION_5SEC]);
+				_geo->time5Seconds();
+			}
+		}
+
+		// leave every popup unanswered, the game deletes popped states next frame
+		_geo->discardPendingEvents();
+		while (!_game->isState(this))
+		{
+			_game->popState();
+		}
+
+		BenchmarkScope scope(_counters[SECTION_IDLE]);
+		int idle = _geo->getIdleSteps(steps - i - 1);
+		if (idle > 0)
+		{
+			_geo->skipIdleSteps(idle);
+			i += idle;
+		}
+	}
+}
+
+/**
+ * Logs the time spent in every trigger, and the resulting game
+ * state so runs of different builds can be checked for determinism.
+ */
+void GeoscapeBenchmarkState::report()
+{
+	SavedGame *save = _game->getSavedGame();
+	GameTime *time = save->getTime();
+	Benchmark::report("Geoscape benchmark: " + std::to_string(_day) + " days simulated at 1 Day speed", _counters);
+	Log(LOG_INFO) << "Geoscape benchmark: ended on " << time->getYear() << "-" << time->getMonth() << "-" << time->getDay() << " " << time->getHour() << ":" << time->getMinute()
+		<< ", funds " << save->getFunds() << ", " << save->getUfos()->size() << " UFOs, " << save->getAlienMissions().size() << " alien missions"
+		<< ", RNG seed " << RNG::getSeed();
+}
+
+/**
+ * Loads the save on the first frame, then simulates
+ * one day per frame so the game can clean up the states
+ * pushed meanwhile, and quits when done.
+ */
+void GeoscapeBenchmarkState::think()
+{
+	State::think();
+	if (_day < 0)
+	{
+		if (!load())
+		{
+			_game->quit();
+			return;
+		}
+		_day = 0;
+	}
+	else if (_day < _days && _game->getSavedGame()->getEnding() == END_NONE)
+	{
+		runDay();
+		_day++;
+	}
+	else
+	{
+		report();
+		_game->quit();
+	}
+}
+
+}
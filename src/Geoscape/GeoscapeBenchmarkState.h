@@ -0,0 +1,62 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string>
+#include <vector>
+#include "../Engine/State.h"
+#include "../Engine/Benchmark.h"
+
+namespace OpenXcom
+{
+
+class GeoscapeState;
+
+/**
+ * Runs the geoscape logic of a saved game for a number
+ * of days as fast as possible, without player input or
+ * rendering, and logs the time spent in every time trigger.
+ * Popups are discarded and interceptions are called off,
+ * so runs with the same save and seed are reproducible.
+ */
+class GeoscapeBenchmarkState : public State
+{
+private:
+	enum Section { SECTION_5SEC, SECTION_10MIN, SECTION_30MIN, SECTION_1HOUR, SECTION_1DAY, SECTION_1MONTH, SECTION_IDLE, SECTION_DAY, SECTION_COUNT };
+	std::string _filename;
+	int _days, _day;
+	uint64_t _seed;
+	GeoscapeState *_geo;
+	std::vector<BenchmarkCounter> _counters;
+
+	/// Loads the saved game.
+	bool load();
+	/// Simulates one day.
+	void runDay();
+	/// Logs the results.
+	void report();
+public:
+	/// Creates the Geoscape Benchmark state.
+	GeoscapeBenchmarkState(const std::string &filename, int days, uint64_t seed);
+	/// Cleans up the Geoscape Benchmark state.
+	~GeoscapeBenchmarkState();
+	/// Runs the benchmark.
+	void think() override;
+};
+
+}
@@ -135,7 +135,7 @@ namespace OpenXcom
  * Initializes all the elements in the Geoscape screen.
  * @param game Pointer to the core game.
  */
-GeoscapeState::GeoscapeState() : _pause(false), _zoomInEffectDone(false), _zoomOutEffectDone(false), _minimizedDogfights(0)
+GeoscapeState::GeoscapeState() : _pause(false), _zoomInEffectDone(false), _zoomOutEffectDone(false), _activeCraftsGrid(Nautical(300)), _minimizedDogfights(0)
 {
 	int screenWidth = Options::baseXGeoscape;
 	int screenHeight = Options::baseYGeoscape;
@@ -844,6 +844,17 @@ void GeoscapeState::timeAdvance()
 		case TIME_5SEC:
 			time5Seconds();
 		}
+
+		// fast-forward through the steps where nothing can happen
+		if (!_pause)
+		{
+			int idle = getIdleSteps(timeSpan - i - 1);
+			if (idle > 0)
+			{
+				skipIdleSteps(idle);
+				i += idle;
+			}
+		}
 	}
 
 	_pause = !_dogfightsToBeStarted.empty() || _zoomInEffectTimer->isRunning() || _zoomOutEffectTimer->isRunning();
@@ -852,6 +863,92 @@ void GeoscapeState::timeAdvance()
 	_globe->draw();
 }
 
+/**
+ * Checks how many of the following 5 second steps can be skipped,
+ * because time5Seconds() would not change anything during them
+ * except counting down the landed UFOs. No craft or UFO can be moving,
+ * no dogfight can be running and no step can trigger the 10 minute
+ * (or longer) logic, so skipping gives the same result as stepping.
+ * @param maxSteps Maximum number of steps to skip.
+ * @return Number of steps that can be skipped.
+ */
+int GeoscapeState::getIdleSteps(int maxSteps)
+{
+	SavedGame *save = _game->getSavedGame();
+	if (maxSteps <= 0 || save->getBases()->empty() || save->getEnding() == END_LOSE || !_dogfights.empty() || !_dogfightsToBeStarted.empty())
+	{
+		return 0;
+	}
+
+	// the step that crosses the next 10 minute mark has to run normally
+	const GameTime *time = save->getTime();
+	int steps = std::min(maxSteps, ((9 - time->getMinute() % 10) * 60 + (55 - time->getSecond())) / 5);
+
+	for (const Ufo *ufo : *save->getUfos())
+	{
+		switch (ufo->getStatus())
+		{
+		case Ufo::LANDED:
+			// leave the step that reaches zero (lift off) to the normal logic
+			steps = std::min(steps, (int)(ufo->getSecondsRemaining() / 5) - 1);
+			break;
+		case Ufo::CRASHED:
+			if (!ufo->getDetected() || ufo->getSecondsRemaining() == 0)
+			{
+				return 0;
+			}
+			break;
+		default:
+			return 0;
+		}
+		if (steps <= 0)
+		{
+			return 0;
+		}
+	}
+	for (const Base *base : *save->getBases())
+	{
+		for (const Craft *craft : *base->getCrafts())
+		{
+			if (!craft->isIdle())
+			{
+				return 0;
+			}
+		}
+	}
+	for (Waypoint *way : *save->getWaypoints())
+	{
+		if (way->getFollowers()->empty())
+		{
+			return 0;
+		}
+	}
+	return std::max(steps, 0);
+}
+
+/**
+ * Advances the game time through idle 5 second steps,
+ * applying the only thing that changes in them:
+ * the landed UFOs countdown.
+ * @param steps Number of steps, as returned by getIdleSteps().
+ */
+void GeoscapeState::skipIdleSteps(int steps)
+{
+	for (int i = 0; i < steps; ++i)
+	{
+		TimeTrigger trigger = _game->getSavedGame()->getTime()->advance();
+		assert(trigger == TIME_5SEC && "Skipped a timed event.");
+		(void)trigger;
+	}
+	for (Ufo *ufo : *_game->getSavedGame()->getUfos())
+	{
+		if (ufo->getStatus() == Ufo::LANDED)
+		{
+			ufo->setSecondsRemaining(ufo->getSecondsRemaining() - 5 * steps);
+		}
+	}
+}
+
 /**
  * Update list of active crafts.
  * @return Const pointer to updated list.
@@ -872,6 +969,18 @@ const std::vector<Craft*>* GeoscapeState::updateActiveCrafts()
 	return &_activeCrafts;
 }
 
+/**
+ * Update spatial index of active crafts, used for range checks
+ * against many crafts at once (eg. hunter-killer radar).
+ * @return Const pointer to updated index.
+ */
+const TargetGrid* GeoscapeState::updateActiveCraftsGrid()
+{
+	_activeCraftsGrid.clear();
+	_activeCraftsGrid.insert(*updateActiveCrafts());
+	return &_activeCraftsGrid;
+}
+
 /**
  * Takes care of any game logic that has to
  * run every game second, like craft movement.
@@ -1537,7 +1646,7 @@ void GeoscapeState::time10Minutes()
 
 void GeoscapeState::ufoHuntingAndEscorting()
 {
-	auto crafts = updateActiveCrafts();
+	auto grid = updateActiveCraftsGrid();
 
 	for (std::vector<Ufo*>::iterator ufo = _game->getSavedGame()->getUfos()->begin(); ufo != _game->getSavedGame()->getUfos()->end(); ++ufo)
 	{
@@ -1561,8 +1670,17 @@ void GeoscapeState::ufoHuntingAndEscorting()
 			}
 
 			// look for more attractive target
-			for (auto craft : *crafts)
+			if ((*ufo)->getCraftStats().radarRange > 0)
+			{
+				grid->query(*ufo, Nautical((*ufo)->getCraftStats().radarRange), _nearbyTargets);
+			}
+			else
 			{
+				_nearbyTargets.clear();
+			}
+			for (auto target : _nearbyTargets)
+			{
+				auto craft = static_cast<Craft*>(target);
 				if (!craft->getMissionComplete())
 				{
 					int tmpAttraction = craft->getHunterKillerAttraction((*ufo)->getHuntMode());
@@ -1627,7 +1745,7 @@ void GeoscapeState::ufoHuntingAndEscorting()
 
 void GeoscapeState::baseHunting()
 {
-	auto crafts = updateActiveCrafts();
+	auto grid = updateActiveCraftsGrid();
 
 	for (std::vector<AlienBase*>::iterator ab = _game->getSavedGame()->getAlienBases()->begin(); ab != _game->getSavedGame()->getAlienBases()->end(); ++ab)
 	{
@@ -1641,8 +1759,10 @@ void GeoscapeState::baseHunting()
 			{
 				// Look for nearby craft
 				bool started = false;
-				for (auto craft : *crafts)
+				grid->query(*ab, Nautical((*ab)->getDeployment()->getBaseDetectionRange()), _nearbyTargets);
+				for (auto target : _nearbyTargets)
 				{
+					auto craft = static_cast<Craft*>(target);
 					// Craft is flying (i.e. not in base)
 					if (craft->getStatus() == "STR_OUT" && !craft->isDestroyed())
 					{
@@ -2762,6 +2882,15 @@ void GeoscapeState::timerReset()
 	_btn5Secs->mousePress(&act, this);
 }
 
+/**
+ * Sets the timer to the 1 Day speed without any input,
+ * for running the geoscape logic unattended.
+ */
+void GeoscapeState::timerFastest()
+{
+	_timeSpeed = _btn1Day;
+}
+
 /**
  * Adds a new popup window to the queue
  * (this prevents popups from overlapping)
@@ -2774,6 +2903,27 @@ void GeoscapeState::popup(State *state)
 	_popups.push_back(state);
 }
 
+/**
+ * Throws away all popups and dogfights waiting for the player,
+ * sending the crafts involved back to their bases, so the
+ * geoscape logic can keep running unattended.
+ */
+void GeoscapeState::discardPendingEvents()
+{
+	Collections::deleteAll(_popups);
+	for (auto *list : { &_dogfights, &_dogfightsToBeStarted })
+	{
+		for (auto *dogfight : *list)
+		{
+			dogfight->getCraft()->returnToBase();
+			delete dogfight;
+		}
+		list->clear();
+	}
+	_minimizedDogfights = 0;
+	_pause = false;
+}
+
 /**
  * Returns a pointer to the Geoscape globe for
  * access by other substates.
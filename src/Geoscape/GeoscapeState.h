@@ -18,6 +18,7 @@
  * along with OpenXcom.  If not, see <http:///www.gnu.org/licenses/>.
  */
 #include "../Engine/State.h"
+#include "../Savegame/TargetGrid.h"
 #include <list>
 
 namespace OpenXcom
@@ -33,6 +34,7 @@ class Timer;
 class DogfightState;
 class Craft;
 class Ufo;
+class Target;
 class MissionSite;
 class Base;
 class RuleMissionScript;
@@ -60,10 +62,14 @@ private:
 	std::list<State*> _popups;
 	std::list<DogfightState*> _dogfights, _dogfightsToBeStarted;
 	std::vector<Craft*> _activeCrafts;
+	TargetGrid _activeCraftsGrid;
+	std::vector<Target*> _nearbyTargets;
 	size_t _minimizedDogfights;
 
 	/// Update list of active crafts.
 	const std::vector<Craft*>* updateActiveCrafts();
+	/// Update spatial index of active crafts.
+	const TargetGrid* updateActiveCraftsGrid();
 
 	void cbxRegionChange(Action *action);
 	void cbxZoneChange(Action *action);
@@ -99,8 +105,16 @@ public:
 	void time1Month();
 	/// Resets the timer to minimum speed.
 	void timerReset();
+	/// Sets the timer to maximum speed.
+	void timerFastest();
+	/// Gets how many of the next 5 second steps would not change anything.
+	int getIdleSteps(int maxSteps);
+	/// Skips a number of idle 5 second steps.
+	void skipIdleSteps(int steps);
 	/// Displays a popup window.
 	void popup(State *state);
+	/// Throws away the pending popups and dogfights.
+	void discardPendingEvents();
 	/// Gets the Geoscape globe.
 	Globe *getGlobe() const;
 	/// Handler for clicking the globe.
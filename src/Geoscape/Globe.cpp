@@ -18,8 +18,11 @@
  */
 #include "Globe.h"
 #include <algorithm>
+#include <cstring>
 #include "../fmath.h"
 #include "../Engine/Action.h"
+#include "../Engine/Benchmark.h"
+#include "../Engine/BlitKernels.h"
 #include "../Engine/SurfaceSet.h"
 #include "../Engine/Timer.h"
 #include "../Mod/Mod.h"
@@ -35,6 +38,7 @@
 #include "../Mod/RuleCountry.h"
 #include "../Interface/Text.h"
 #include "../Engine/LocalizedText.h"
+#include "../Engine/Logger.h"
 #include "../Mod/RuleRegion.h"
 #include "../Savegame/Region.h"
 #include "../Mod/City.h"
@@ -55,12 +59,31 @@
 #include "../Mod/Texture.h"
 #include "../Interface/Cursor.h"
 #include "../Engine/Screen.h"
+#include "../Engine/WorkerPool.h"
+
+// the vector shadow kernels only give the same pixels as the scalar code when it does its double math with SSE2 too
+#if defined(__SSE2_MATH__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GLOBE_SHADOW_SSE2
+#include <emmintrin.h>
+// AVX code is built for every target and only called after checking the CPU
+#if defined(__GNUC__)
+#define GLOBE_SHADOW_AVX
+#define GLOBE_SHADOW_AVX_TARGET __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(_MSC_VER)
+#define GLOBE_SHADOW_AVX
+#define GLOBE_SHADOW_AVX_TARGET
+#include <immintrin.h>
+#endif
+#endif
 
 namespace OpenXcom
 {
 
 const double Globe::ROTATE_LONGITUDE = 0.10;
 const double Globe::ROTATE_LATITUDE = 0.06;
+/// How far the sun has to move before the shadow is redrawn, about one game minute.
+const double Globe::SHADOW_SUN_STEP = 0.0044;
 
 Uint8 Globe::OCEAN_COLOR;
 bool Globe::OCEAN_SHADING;
@@ -235,7 +258,7 @@ struct Ocean
 
 struct CreateShadow
 {
-	static inline Uint8 getShadowValue(const Cord& earth, const Cord& sun, const Sint16& noise)
+	static inline double getShadowDistance(const Cord& earth, const Cord& sun, const Sint16& noise)
 	{
 		Cord temp = earth;
 		//diff
@@ -254,9 +277,13 @@ struct CreateShadow
 		temp.x -= static_data.getDistanceNoise(noise);
 		//random noise than increase with distance from middle of twilight
 		temp.x += static_data.getMultiplierNoise(noise) * 4 * (temp.x - GlobeStaticData::shade_gradient_max / 2) / GlobeStaticData::shade_gradient_max;
+		return temp.x;
+	}
 
+	static inline Uint8 getShadowFromDistance(double distance, const Sint16& noise)
+	{
 		double full = 0;
-		double rem = std::modf(temp.x, &full);
+		double rem = std::modf(distance, &full);
 		int offset = Clamp((int)full, 0, GlobeStaticData::shade_gradient_max - 1);
 		int i = static_data.shade_gradient[offset];
 
@@ -267,6 +294,11 @@ struct CreateShadow
 		return Clamp(i, 0, 31);
 	}
 
+	static inline Uint8 getShadowValue(const Cord& earth, const Cord& sun, const Sint16& noise)
+	{
+		return getShadowFromDistance(getShadowDistance(earth, sun, noise), noise);
+	}
+
 	static inline Uint8 getOceanShadow(const Uint8& shadow)
 	{
 		return Globe::OCEAN_COLOR + shadow;
@@ -292,24 +324,274 @@ struct CreateShadow
 	{
 		if (dest && earth.z)
 		{
-			const Uint8 shadow = getShadowValue(earth, sun, noise);
-			//this pixel is ocean
-			if (isOcean(dest))
+			shade(dest, getShadowValue(earth, sun, noise));
+		}
+		else
+		{
+			dest = 0;
+		}
+	}
+
+	static inline void shade(Uint8& dest, const Uint8& shadow)
+	{
+		//this pixel is ocean
+		if (isOcean(dest))
+		{
+			dest = getOceanShadow(shadow);
+		}
+		//this pixel is land
+		else
+		{
+			dest = getLandShadow(dest, shadow);
+		}
+	}
+
+	/**
+	 * Shades a row of the globe the same as func(), with the distances
+	 * of up to 4 pixels already computed by a vector kernel.
+	 */
+	static inline void shadeFromDistances(Uint8 *dest, const Cord *earth, const double *distance, const Sint16 *noise, int count)
+	{
+		for (int i = 0; i < count; ++i)
+		{
+			if (dest[i] && earth[i].z)
 			{
-				dest = getOceanShadow(shadow);
+				shade(dest[i], getShadowFromDistance(distance[i], noise[i]));
 			}
-			//this pixel is land
 			else
 			{
-				dest = getLandShadow(dest, shadow);
+				dest[i] = 0;
 			}
 		}
-		else
+	}
+};
+
+typedef void (*ShadowRowFunc)(Uint8 *dest, const Cord *earth, const Sint16 *noise, int count, const Cord &sun);
+
+/**
+ * Shades a row of pixels one at a time.
+ * @param dest First pixel of the row.
+ * @param earth Globe normals of the pixels.
+ * @param noise Noise of the pixels.
+ * @param count Number of pixels.
+ * @param sun Sun direction.
+ */
+void shadowRowScalar(Uint8 *dest, const Cord *earth, const Sint16 *noise, int count, const Cord &sun)
+{
+	for (int i = 0; i < count; ++i)
+	{
+		CreateShadow::func(dest[i], earth[i], sun, noise[i]);
+	}
+}
+
+#ifdef GLOBE_SHADOW_SSE2
+/**
+ * Same as shadowRowScalar, computing the distance to the sun
+ * and the noise of 2 pixels at a time. It does the same double
+ * operations in the same order, so the results are identical.
+ */
+void shadowRowSSE2(Uint8 *dest, const Cord *earth, const Sint16 *noise, int count, const Cord &sun)
+{
+	const __m128d sunX = _mm_set1_pd(sun.x), sunY = _mm_set1_pd(sun.y), sunZ = _mm_set1_pd(sun.z);
+	const __m128d two = _mm_set1_pd(2), scale = _mm_set1_pd(125.), half = _mm_set1_pd(GlobeStaticData::shade_gradient_max / 2), max = _mm_set1_pd(GlobeStaticData::shade_gradient_max);
+	int i = 0;
+	for (; i + 2 <= count; i += 2)
+	{
+		const Cord *e = earth + i;
+		const Sint16 *n = noise + i;
+		__m128d x = _mm_sub_pd(_mm_set_pd(e[1].x, e[0].x), sunX);
+		__m128d y = _mm_sub_pd(_mm_set_pd(e[1].y, e[0].y), sunY);
+		__m128d z = _mm_sub_pd(_mm_set_pd(e[1].z, e[0].z), sunZ);
+		x = _mm_mul_pd(x, x);
+		y = _mm_mul_pd(y, y);
+		z = _mm_mul_pd(z, z);
+		x = _mm_add_pd(x, _mm_add_pd(z, y));
+		x = _mm_add_pd(_mm_mul_pd(_mm_sub_pd(x, two), scale), half);
+		x = _mm_sub_pd(x, _mm_set_pd(static_data.getDistanceNoise(n[1]), static_data.getDistanceNoise(n[0])));
+		__m128d multiplier = _mm_set_pd(static_data.getMultiplierNoise(n[1]) * 4, static_data.getMultiplierNoise(n[0]) * 4);
+		x = _mm_add_pd(x, _mm_div_pd(_mm_mul_pd(multiplier, _mm_sub_pd(x, half)), max));
+		double distance[2];
+		_mm_storeu_pd(distance, x);
+		CreateShadow::shadeFromDistances(dest + i, e, distance, n, 2);
+	}
+	shadowRowScalar(dest + i, earth + i, noise + i, count - i, sun);
+}
+#endif
+
+#ifdef GLOBE_SHADOW_AVX
+/**
+ * Same as shadowRowSSE2, 4 pixels at a time.
+ */
+GLOBE_SHADOW_AVX_TARGET void shadowRowAVX(Uint8 *dest, const Cord *earth, const Sint16 *noise, int count, const Cord &sun)
+{
+	const __m256d sunX = _mm256_set1_pd(sun.x), sunY = _mm256_set1_pd(sun.y), sunZ = _mm256_set1_pd(sun.z);
+	const __m256d two = _mm256_set1_pd(2), scale = _mm256_set1_pd(125.), half = _mm256_set1_pd(GlobeStaticData::shade_gradient_max / 2), max = _mm256_set1_pd(GlobeStaticData::shade_gradient_max);
+	int i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		const Cord *e = earth + i;
+		const Sint16 *n = noise + i;
+		__m256d x = _mm256_sub_pd(_mm256_set_pd(e[3].x, e[2].x, e[1].x, e[0].x), sunX);
+		__m256d y = _mm256_sub_pd(_mm256_set_pd(e[3].y, e[2].y, e[1].y, e[0].y), sunY);
+		__m256d z = _mm256_sub_pd(_mm256_set_pd(e[3].z, e[2].z, e[1].z, e[0].z), sunZ);
+		x = _mm256_mul_pd(x, x);
+		y = _mm256_mul_pd(y, y);
+		z = _mm256_mul_pd(z, z);
+		x = _mm256_add_pd(x, _mm256_add_pd(z, y));
+		x = _mm256_add_pd(_mm256_mul_pd(_mm256_sub_pd(x, two), scale), half);
+		x = _mm256_sub_pd(x, _mm256_set_pd(static_data.getDistanceNoise(n[3]), static_data.getDistanceNoise(n[2]), static_data.getDistanceNoise(n[1]), static_data.getDistanceNoise(n[0])));
+		__m256d multiplier = _mm256_set_pd(static_data.getMultiplierNoise(n[3]) * 4, static_data.getMultiplierNoise(n[2]) * 4, static_data.getMultiplierNoise(n[1]) * 4, static_data.getMultiplierNoise(n[0]) * 4);
+		x = _mm256_add_pd(x, _mm256_div_pd(_mm256_mul_pd(multiplier, _mm256_sub_pd(x, half)), max));
+		double distance[4];
+		_mm256_storeu_pd(distance, x);
+		CreateShadow::shadeFromDistances(dest + i, e, distance, n, 4);
+	}
+	shadowRowScalar(dest + i, earth + i, noise + i, count - i, sun);
+}
+#endif
+
+/**
+ * Gets the row shader for an instruction set of the blitters.
+ * Sets this build can't use for the shadow fall back to a lower one.
+ * @param level Instruction set.
+ * @return Row shader.
+ */
+ShadowRowFunc getShadowRowFunc(BlitKernelLevel level)
+{
+#ifdef GLOBE_SHADOW_AVX
+	if (level >= BLIT_AVX2)
+	{
+		return shadowRowAVX;
+	}
+#endif
+#ifdef GLOBE_SHADOW_SSE2
+	if (level >= BLIT_SSE2)
+	{
+		return shadowRowSSE2;
+	}
+#endif
+	return shadowRowScalar;
+}
+
+/**
+ * Shades rows of the globe, with the pixels outside
+ * of the earth just cleared.
+ * @param func Row shader.
+ * @param dest Globe pixels, starting at the first row to shade.
+ * @param pitch Bytes between two rows of the globe.
+ * @param earth Globe normals, starting at the same pixel as dest.
+ * @param earthPitch Normals between two rows.
+ * @param x Column of the first pixel in each row.
+ * @param y Row of the first row.
+ * @param width Number of pixels in each row.
+ * @param height Number of rows.
+ * @param sun Sun direction.
+ */
+void shadowRows(ShadowRowFunc func, Uint8 *dest, int pitch, const Cord *earth, int earthPitch, int x, int y, int width, int height, const Cord &sun)
+{
+	const int size = GlobeStaticData::random_surf_size;
+	Sint16 noise[1024];
+	for (int row = 0; row < height; ++row, dest += pitch, earth += earthPitch)
+	{
+		int begin = 0, end = width;
+		while (begin < end && !earth[begin].z)
+			++begin;
+		while (end > begin && !earth[end - 1].z)
+			--end;
+		std::memset(dest, 0, begin);
+		std::memset(dest + end, 0, width - end);
+
+		const Sint16 *noiseRow = static_data.random_noise + ((y + row) % size) * size;
+		for (int i = begin; i < end; i += 1024)
 		{
-			dest = 0;
+			const int count = std::min(end - i, 1024);
+			for (int j = 0, n = (x + i) % size; j < count; ++j, n = n + 1 < size ? n + 1 : 0)
+			{
+				noise[j] = noiseRow[n];
+			}
+			func(dest + i, earth + i, noise, count, sun);
 		}
 	}
-};
+}
+
+/**
+ * Walks the pixels of a clipped line, the way the radar
+ * and flight path lines of the globe are drawn.
+ * @param x1 X of the start of the line.
+ * @param y1 Y of the start of the line.
+ * @param x2 X of the end of the line.
+ * @param y2 Y of the end of the line.
+ * @param pixel Called with the coordinates of every pixel.
+ */
+template<typename F>
+void walkLine(double x1, double y1, double x2, double y2, F pixel)
+{
+	double deltax = x2-x1, deltay = y2-y1;
+	bool inv;
+	double len,x0,y0,SX,SY;
+	if (abs((int)y2-(int)y1) > abs((int)x2-(int)x1))
+	{
+		len=abs((int)y2-(int)y1);
+		inv=false;
+	}
+	else
+	{
+		len=abs((int)x2-(int)x1);
+		inv=true;
+	}
+
+	if (y2 < y1) {
+		SY = -1;
+	}
+	else if (AreSame(deltay, 0.0)) {
+		SY = 0;
+	}
+	else {
+		SY = 1;
+	}
+
+	if (x2 < x1) {
+		SX = -1;
+	}
+	else if (AreSame(deltax, 0.0)) {
+		SX = 0;
+	}
+	else {
+		SX = 1;
+	}
+
+	x0=x1;  y0=y1;
+	if (inv)
+		SY=(deltay/len);
+	else
+		SX=(deltax/len);
+
+	while (len>0)
+	{
+		pixel((int)x0, (int)y0);
+		x0+=SX;
+		y0+=SY;
+		len-=1.0;
+	}
+}
+
+/**
+ * Gets the color of a pixel under a radar or flight path line.
+ * @param tcol Pixel of the unshaded globe.
+ * @param shade Shade of the line.
+ * @return Color of the line.
+ */
+inline Uint8 getLineColor(Uint8 tcol, int shade)
+{
+	if (CreateShadow::isOcean(tcol))
+	{
+		return CreateShadow::getOceanShadow(shade + 8);
+	}
+	else
+	{
+		return CreateShadow::getLandShadow(tcol, shade * 3);
+	}
+}
 
 }//namespace
 
@@ -324,7 +606,7 @@ struct CreateShadow
  * @param x X position in pixels.
  * @param y Y position in pixels.
  */
-Globe::Globe(Game* game, int cenX, int cenY, int width, int height, int x, int y) : InteractiveSurface(width, height, x, y), _cenX(cenX), _cenY(cenY), _rotLon(0.0), _rotLat(0.0), _hoverLon(0.0), _hoverLat(0.0), _craftLon(0.0), _craftLat(0.0), _craftRange(0.0), _game(game), _hover(false), _craft(false), _blink(-1),
+Globe::Globe(Game* game, int cenX, int cenY, int width, int height, int x, int y) : InteractiveSurface(width, height, x, y), _cenX(cenX), _cenY(cenY), _rotLon(0.0), _rotLat(0.0), _hoverLon(0.0), _hoverLat(0.0), _craftLon(0.0), _craftLat(0.0), _craftRange(0.0), _game(game), _landLon(0.0), _landLat(0.0), _landRadius(0.0), _landZoom(0), _landValid(false), _radarValid(false), _hover(false), _craft(false), _blink(-1),
 																					_isMouseScrolling(false), _isMouseScrolled(false), _xBeforeMouseScrolling(0), _yBeforeMouseScrolling(0), _lonBeforeMouseScrolling(0.0), _latBeforeMouseScrolling(0.0), _mouseScrollingStartTime(0), _totalMouseMoveX(0), _totalMouseMoveY(0), _mouseMovedOverThreshold(false)
 {
 	_rules = game->getMod()->getGlobe();
@@ -334,6 +616,7 @@ Globe::Globe(Game* game, int cenX, int cenY, int width, int height, int x, int y
 	_countries = new Surface(width, height, x, y);
 	_markers = new Surface(width, height, x, y);
 	_radars = new Surface(width, height, x, y);
+	_land = new Surface(width, height, x, y);
 	_clipper = new FastLineClip(x, x+width, y, y+height);
 
 	// Animation timers
@@ -365,6 +648,7 @@ Globe::~Globe()
 	delete _markers;
 	delete _texture;
 	delete _radars;
+	delete _land;
 	delete _clipper;
 
 	for (std::list<Polygon*>::iterator i = _cacheLand.begin(); i != _cacheLand.end(); ++i)
@@ -916,6 +1200,7 @@ void Globe::setPalette(const SDL_Color *colors, int firstcolor, int ncolors)
 	_countries->setPalette(colors, firstcolor, ncolors);
 	_markers->setPalette(colors, firstcolor, ncolors);
 	_radars->setPalette(colors, firstcolor, ncolors);
+	_land->setPalette(colors, firstcolor, ncolors);
 }
 
 /**
@@ -952,20 +1237,41 @@ void Globe::rotate()
 }
 
 /**
- * Draws the whole globe, part by part.
+ * Draws the whole globe, part by part. The ocean and land
+ * are only redrawn when the globe is rotated, zoomed or
+ * resized, and the shadow only when the land was redrawn
+ * or the sun has moved noticeably since the last time.
  */
 void Globe::draw()
 {
-	if (_redraw)
+	BenchmarkSectionScope benchmark(BENCHMARK_GLOBE);
+	_redraw = false;
+	bool landChanged = !_landValid || _landLon != _cenLon || _landLat != _cenLat || _landRadius != _radius || _landZoom != _zoom;
+	if (landChanged)
 	{
+		BenchmarkSectionScope benchmarkLand(BENCHMARK_GLOBE_LAND);
 		cachePolygons();
+		_land->clear();
+		drawOcean();
+		drawLand();
+		_landLon = _cenLon;
+		_landLat = _cenLat;
+		_landRadius = _radius;
+		_landZoom = _zoom;
+		_landValid = true;
+		invalidateRadars();
 	}
-	Surface::draw();
-	drawOcean();
-	drawLand();
 	drawRadars();
 	drawFlights();
-	drawShadow();
+	Cord sun = getSunDirection(_cenLon, _cenLat);
+	Cord sunMoved = sun;
+	sunMoved -= _shadowSun;
+	if (landChanged || sunMoved.norm() > SHADOW_SUN_STEP)
+	{
+		BenchmarkSectionScope benchmarkShadow(BENCHMARK_GLOBE_SHADOW);
+		_shadowSun = sun;
+		drawShadow();
+	}
 	drawMarkers();
 	drawDetail();
 }
@@ -976,10 +1282,10 @@ void Globe::draw()
  */
 void Globe::drawOcean()
 {
-	lock();
-	drawCircle(_cenX+1, _cenY, _radius+20, OCEAN_COLOR);
-//	ShaderDraw<Ocean>(ShaderSurface(this));
-	unlock();
+	_land->lock();
+	_land->drawCircle(_cenX+1, _cenY, _radius+20, OCEAN_COLOR);
+//	ShaderDraw<Ocean>(ShaderSurface(_land));
+	_land->unlock();
 }
 
 
@@ -1003,7 +1309,7 @@ void Globe::drawLand()
 		}
 
 		// Apply textures according to zoom and shade
-		drawTexturedPolygon(x, y, (*i)->getPoints(), _texture->getFrame((*i)->getTexture() + _zoomTexture), 0, 0);
+		_land->drawTexturedPolygon(x, y, (*i)->getPoints(), _texture->getFrame((*i)->getTexture() + _zoomTexture), 0, 0);
 	}
 }
 
@@ -1062,110 +1368,152 @@ Cord Globe::getSunDirection(double lon, double lat) const
 	return sun_direction;
 }
 
-
+/**
+ * Copies the cached ocean and land onto the globe
+ * and shades it with the sun position of the last draw.
+ * Bands of rows are shaded in parallel, with the vector
+ * instructions the blitters use, giving the same pixels
+ * as the CreateShadow shader.
+ */
 void Globe::drawShadow()
 {
-	auto earth = ShaderMove<Cord>(SurfaceRaw<Cord>(_earthData[_zoom], getWidth(), getHeight()));
-	auto noise = ShaderRepeat<Sint16>(SurfaceRaw<Sint16>(static_data.random_noise, static_data.random_surf_size, static_data.random_surf_size));
-
-	earth.setMove(_cenX-getWidth()/2, _cenY-getHeight()/2);
+	const int width = getWidth(), height = getHeight();
+	const int moveX = _cenX - width / 2, moveY = _cenY - height / 2;
+	const int beginX = std::max(moveX, 0), endX = std::min(width + moveX, width);
+	const int beginY = std::max(moveY, 0), endY = std::min(height + moveY, height);
+	const Cord *earth = _earthData[_zoom].data();
+	const ShadowRowFunc func = getShadowRowFunc(BlitKernels::getLevel());
+	const int bands = (height + SHADOW_BAND_HEIGHT - 1) / SHADOW_BAND_HEIGHT;
 
 	lock();
-	ShaderDraw<CreateShadow>(ShaderSurface(this), earth, ShaderScalar(getSunDirection(_cenLon, _cenLat)), noise);
+	_land->lock();
+	WorkerPool::getShared()->run(bands, [&](int band)
+	{
+		const int first = band * SHADOW_BAND_HEIGHT;
+		const int last = std::min(first + SHADOW_BAND_HEIGHT, height);
+		for (int y = first; y < last; ++y)
+		{
+			std::memcpy(getRaw(0, y), _land->getRaw(0, y), width);
+		}
+		const int shadeFirst = std::max(first, beginY), shadeLast = std::min(last, endY);
+		if (shadeFirst < shadeLast && beginX < endX)
+		{
+			shadowRows(func, getRaw(beginX, shadeFirst), getSurface()->pitch, earth + (shadeFirst - moveY) * width + (beginX - moveX), width, beginX, shadeFirst, endX - beginX, shadeLast - shadeFirst, _shadowSun);
+		}
+	});
+	_land->unlock();
 	unlock();
-
 }
 
-
-void Globe::XuLine(Surface* surface, Surface* src, double x1, double y1, double x2, double y2, int shade)
+/**
+ * Times the globe shadow at every instruction set the blitters
+ * support, for every zoom level, and checks that each gives
+ * the same pixels as the CreateShadow shader.
+ * @param rounds Number of times each zoom level is shaded.
+ * @return True if all the pixels were the same.
+ */
+bool Globe::benchmarkShadow(int rounds)
 {
-	if (_clipper->LineClip(&x1,&y1,&x2,&y2) != 1) return; //empty line
+	const int width = 320 - 64, height = 200;
+	const double radii[] = { 0.45, 0.60, 0.90, 1.40, 2.25, 3.60 };
 
-	double deltax = x2-x1, deltay = y2-y1;
-	bool inv;
-	Sint16 tcol;
-	double len,x0,y0,SX,SY;
-	if (abs((int)y2-(int)y1) > abs((int)x2-(int)x1))
+	// fixed pseudo-random land and ocean inside the globe, like drawLand() leaves it
+	Uint32 seed = 12345;
+	auto next = [&seed]() { seed = seed * 1103515245 + 12345; return (seed >> 16) & 0xFF; };
+	std::vector<Uint8> land(width * height);
+	for (auto &p : land)
 	{
-		len=abs((int)y2-(int)y1);
-		inv=false;
+		p = next() % 4 ? next() : OCEAN_COLOR;
 	}
-	else
+
+	std::vector<BenchmarkCounter> counters;
+	bool ok = true;
+	for (int level = BLIT_SCALAR; level <= BlitKernels::getSupportedLevel(); ++level)
 	{
-		len=abs((int)x2-(int)x1);
-		inv=true;
+		counters.push_back(BenchmarkCounter(std::string("shadow ") + BlitKernels::getLevelName((BlitKernelLevel)level)));
 	}
+	for (double radius : radii)
+	{
+		std::vector<Cord> earth(width * height);
+		for (int j = 0; j < height; ++j)
+		{
+			for (int i = 0; i < width; ++i)
+			{
+				earth[width * j + i] = static_data.circle_norm(width / 2, height / 2, radius * height, i + .5, j + .5);
+			}
+		}
+		for (int r = 0; r < rounds; ++r)
+		{
+			// the sun goes around the globe over the rounds, crossing the terminator everywhere
+			const double angle = 2 * M_PI * r / std::max(rounds, 1);
+			const Cord sun(cos(angle), sin(angle) * 0.3, sin(angle) * 0.95);
 
-	if (y2 < y1) {
-		SY = -1;
-	}
-	else if (AreSame(deltay, 0.0)) {
-		SY = 0;
-	}
-	else {
-		SY = 1;
-	}
+			std::vector<Uint8> reference = land;
+			ShaderDraw<CreateShadow>(ShaderSurface(SurfaceRaw<Uint8>(reference, width, height)), ShaderSurface(SurfaceRaw<Cord>(earth, width, height)), ShaderScalar(sun),
+				ShaderRepeat<Sint16>(SurfaceRaw<Sint16>(static_data.random_noise, static_data.random_surf_size, static_data.random_surf_size)));
 
-	if (x2 < x1) {
-		SX = -1;
-	}
-	else if (AreSame(deltax, 0.0)) {
-		SX = 0;
-	}
-	else {
-		SX = 1;
+			for (int level = BLIT_SCALAR; level <= BlitKernels::getSupportedLevel(); ++level)
+			{
+				std::vector<Uint8> pixels = land;
+				{
+					BenchmarkScope scope(counters[level]);
+					shadowRows(getShadowRowFunc((BlitKernelLevel)level), pixels.data(), width, earth.data(), width, 0, 0, width, height, sun);
+				}
+				if (pixels != reference)
+				{
+					Log(LOG_ERROR) << "Globe shadow benchmark: " << counters[level].name << " differs from the shader at zoom radius " << radius << ".";
+					ok = false;
+				}
+			}
+		}
 	}
 
-	x0=x1;  y0=y1;
-	if (inv)
-		SY=(deltay/len);
-	else
-		SX=(deltax/len);
+	Benchmark::report("Globe shadow benchmark: " + std::to_string(rounds) + " rounds, best level " + BlitKernels::getLevelName(BlitKernels::getSupportedLevel()), counters);
+	return ok;
+}
 
-	while (len>0)
+
+void Globe::XuLine(Surface* surface, Surface* src, double x1, double y1, double x2, double y2, int shade)
+{
+	if (_clipper->LineClip(&x1,&y1,&x2,&y2) != 1) return; //empty line
+
+	walkLine(x1, y1, x2, y2, [&](int x, int y)
 	{
-		tcol=src->getPixel((int)x0,(int)y0);
+		Uint8 tcol = src->getPixel(x, y);
 		if (tcol)
 		{
-			if (CreateShadow::isOcean(tcol))
-			{
-				tcol = CreateShadow::getOceanShadow(shade + 8);
-			}
-			else
-			{
-				tcol = CreateShadow::getLandShadow(tcol, shade * 3);
-			}
-			surface->setPixel((int)x0,(int)y0,tcol);
+			surface->setPixel(x, y, getLineColor(tcol, shade));
 		}
-		x0+=SX;
-		y0+=SY;
-		len-=1.0;
-	}
+	});
 }
 
 /**
  * Draws the radar ranges of player bases, player craft, alien bases and UFO hunter-killers on the globe.
+ * The outlines of the ranges are kept from one draw to the next, and they are
+ * merged into a coverage mask that is only rebuilt when a range or the view
+ * changes, so most draws just copy the covered pixels.
  */
 void Globe::drawRadars()
 {
 	_radars->clear();
 
-	if (!Options::globeRadarLines)
+	// the coverage is colored from the land, which is drawn again first
+	if (!Options::globeRadarLines || !_landValid)
 		return;
 
+	BenchmarkSectionScope benchmark(BENCHMARK_GLOBE_RADARS);
 	double tr, range;
 	double lat, lon;
 	std::vector<double> ranges;
-
-	_radars->lock();
+	std::vector<RadarCircle> circles;
 
 	// Draw craft range
 	if (_craft)
 	{
 		if (_craftRange < M_PI)
 		{
-			drawGlobeCircle(_craftLat, _craftLon, _craftRange, 64);
-			drawGlobeCircle(_craftLat, _craftLon, _craftRange - 0.025, 64, 2);
+			addRadarCircle(circles, _craftLat, _craftLon, _craftRange, 64);
+			addRadarCircle(circles, _craftLat, _craftLon, _craftRange - 0.025, 64, 2);
 		}
 	}
 
@@ -1175,7 +1523,7 @@ void Globe::drawRadars()
 		for (std::vector<std::string>::const_iterator i = facilities.begin(); i != facilities.end(); ++i)
 		{
 			range = Nautical(_game->getMod()->getBaseFacility(*i)->getRadarRange());
-			drawGlobeCircle(_hoverLat,_hoverLon,range,48);
+			addRadarCircle(circles, _hoverLat, _hoverLon, range, 48);
 			if (Options::globeAllRadarsOnBaseBuild) ranges.push_back(range);
 		}
 	}
@@ -1191,7 +1539,7 @@ void Globe::drawRadars()
 		{
 			if (_hover && Options::globeAllRadarsOnBaseBuild)
 			{
-				for (size_t j=0; j<ranges.size(); j++) drawGlobeCircle(lat,lon,ranges[j],48);
+				for (size_t j=0; j<ranges.size(); j++) addRadarCircle(circles, lat, lon, ranges[j], 48);
 			}
 			else
 			{
@@ -1206,7 +1554,7 @@ void Globe::drawRadars()
 				}
 				range = Nautical(range);
 
-				if (range>0) drawGlobeCircle(lat,lon,range,48);
+				if (range>0) addRadarCircle(circles, lat, lon, range, 48);
 			}
 
 		}
@@ -1220,7 +1568,7 @@ void Globe::drawRadars()
 			lon=(*j)->getLongitude();
 			range = Nautical((*j)->getCraftStats().radarRange);
 
-			if (range>0) drawGlobeCircle(lat,lon,range,24);
+			if (range>0) addRadarCircle(circles, lat, lon, range, 24);
 		}
 	}
 
@@ -1239,7 +1587,7 @@ void Globe::drawRadars()
 				lon = (*u)->getLongitude();
 				range = Nautical((*u)->getCraftStats().radarRange);
 
-				if (range > 0) drawGlobeCircle(lat, lon, range, 24);
+				if (range > 0) addRadarCircle(circles, lat, lon, range, 24);
 			}
 		}
 
@@ -1252,39 +1600,158 @@ void Globe::drawRadars()
 				lon = (*ab)->getLongitude();
 				range = Nautical((*ab)->getDeployment()->getBaseDetectionRange());
 
-				if (range > 0) drawGlobeCircle(lat, lon, range, 24);
+				if (range > 0) addRadarCircle(circles, lat, lon, range, 24);
 			}
 		}
 	}
 
+	bool changed = !_radarValid || circles.size() != _radarCircles.size();
+	for (size_t i = 0; !changed && i < circles.size(); ++i)
+	{
+		changed = circles[i].lat != _radarCircles[i].lat || circles[i].lon != _radarCircles[i].lon || circles[i].radius != _radarCircles[i].radius || circles[i].segments != _radarCircles[i].segments || circles[i].frac != _radarCircles[i].frac;
+	}
+	_radarCircles.swap(circles);
+
+	if (changed)
+	{
+		const int width = _radars->getWidth(), height = _radars->getHeight();
+		_radarMask.resize(width * height);
+		_radarPixels.clear();
+		for (auto &circle : _radarCircles)
+		{
+			maskRadarCircle(circle);
+		}
+		// every covered pixel is only colored once, however many circles cross it
+		_land->lock();
+		size_t kept = 0;
+		for (const auto &p : _radarPixels)
+		{
+			const int x = p.first % width, y = p.first / width;
+			_radarMask[p.first] = 0;
+			Uint8 tcol = _land->getPixel(x, y);
+			if (tcol)
+			{
+				_radarPixels[kept++] = std::make_pair(y * _radars->getPitch() + x, getLineColor(tcol, 6));
+			}
+		}
+		_radarPixels.resize(kept);
+		_land->unlock();
+		_radarValid = true;
+	}
+
+	_radars->lock();
+	Uint8 *pixels = (Uint8*)_radars->getSurface()->pixels;
+	for (const auto &p : _radarPixels)
+	{
+		pixels[p.first] = p.second;
+	}
 	_radars->unlock();
 }
 
 /**
- *	Draw globe range circle
+ * Forgets the radar coverage and circle outlines, so they are
+ * computed again for the current land and size of the globe.
  */
-void Globe::drawGlobeCircle(double lat, double lon, double radius, int segments, int frac)
+void Globe::invalidateRadars()
 {
-	double x, y, x2 = 0, y2 = 0;
-	double lat1, lon1;
+	_radarValid = false;
+	_radarPixels.clear();
+	for (auto &circle : _radarCircles)
+	{
+		circle.projected = false;
+	}
+}
+
+/**
+ * Adds a radar range circle to the list of circles to draw.
+ * The outline of a circle drawn last time is reused, so its
+ * vertices are only computed again when its source moves.
+ * @param circles Circles to draw.
+ * @param lat Latitude of the center.
+ * @param lon Longitude of the center.
+ * @param radius Range in radians.
+ * @param segments Number of segments of the outline.
+ * @param frac Only every frac-th segment is drawn.
+ */
+void Globe::addRadarCircle(std::vector<RadarCircle> &circles, double lat, double lon, double radius, int segments, int frac)
+{
+	// outlines already taken by an earlier circle are empty
+	auto same = [&](const RadarCircle &c) { return !c.lat1.empty() && c.lat == lat && c.lon == lon && c.radius == radius && c.segments == segments && c.frac == frac; };
+	// sources are usually listed in the same order as last time
+	const size_t hint = circles.size();
+	if (hint < _radarCircles.size() && same(_radarCircles[hint]))
+	{
+		circles.push_back(std::move(_radarCircles[hint]));
+		_radarCircles[hint].lat1.clear();
+		return;
+	}
+	auto old = std::find_if(_radarCircles.begin(), _radarCircles.end(), same);
+	if (old != _radarCircles.end())
+	{
+		circles.push_back(std::move(*old));
+		old->lat1.clear();
+		return;
+	}
+
+	RadarCircle circle;
+	circle.lat = lat;
+	circle.lon = lon;
+	circle.radius = radius;
+	circle.segments = segments;
+	circle.frac = frac;
+	circle.projected = false;
 	double seg = M_PI / (static_cast<double>(segments) / 2);
-	int i = 0;
 	for (double az = 0; az <= M_PI*2+0.01; az+=seg) //48 circle segments
 	{
 		//calculating sphere-projected circle
-		lat1 = asin(sin(lat) * cos(radius) + cos(lat) * sin(radius) * cos(az));
-		lon1 = lon + atan2(sin(az) * sin(radius) * cos(lat), cos(radius) - sin(lat) * sin(lat1));
-		polarToCart(lon1, lat1, &x, &y);
-		if ( AreSame(az, 0.0) ) //first vertex is for initialization only
+		double lat1 = asin(sin(lat) * cos(radius) + cos(lat) * sin(radius) * cos(az));
+		double lon1 = lon + atan2(sin(az) * sin(radius) * cos(lat), cos(radius) - sin(lat) * sin(lat1));
+		circle.lat1.push_back(lat1);
+		circle.lon1.push_back(lon1);
+	}
+	circles.push_back(circle);
+}
+
+/**
+ * Marks the pixels of the outline of a radar range circle on
+ * the coverage mask, projecting it first if the globe was
+ * rotated or zoomed since it was last drawn.
+ * @param circle Radar circle.
+ */
+void Globe::maskRadarCircle(RadarCircle &circle)
+{
+	const size_t points = circle.lat1.size();
+	if (!circle.projected)
+	{
+		circle.x.resize(points);
+		circle.y.resize(points);
+		circle.back.resize(points);
+		for (size_t j = 0; j < points; ++j)
 		{
-			x2=x;
-			y2=y;
-			continue;
+			polarToCart(circle.lon1[j], circle.lat1[j], &circle.x[j], &circle.y[j]);
+			circle.back[j] = pointBack(circle.lon1[j], circle.lat1[j]);
+		}
+		circle.projected = true;
+	}
+
+	const int width = _radars->getWidth(), height = _radars->getHeight();
+	for (size_t j = 1; j < points; ++j)
+	{
+		//first vertex is for initialization only
+		if (!circle.back[j] && (j - 1) % circle.frac == 0)
+		{
+			double x1 = circle.x[j], y1 = circle.y[j], x2 = circle.x[j - 1], y2 = circle.y[j - 1];
+			if (_clipper->LineClip(&x1,&y1,&x2,&y2) != 1) continue; //empty line
+
+			walkLine(x1, y1, x2, y2, [&](int x, int y)
+			{
+				if (x >= 0 && x < width && y >= 0 && y < height && !_radarMask[y * width + x])
+				{
+					_radarMask[y * width + x] = 1;
+					_radarPixels.push_back(std::make_pair(y * width + x, 0));
+				}
+			});
 		}
-		if (!pointBack(lon1,lat1) && i % frac == 0)
-			XuLine(_radars, this, x, y, x2, y2, 6);
-		x2=x; y2=y;
-		i++;
 	}
 }
 
@@ -1610,7 +2077,7 @@ void Globe::drawPath(Surface *surface, double lon1, double lat1, double lon2, do
 
 		if (!pointBack(p1.lon, p1.lat) && !pointBack(p2.lon, p2.lat))
 		{
-			XuLine(surface, this, x1, y1, x2, y2, 8);
+			XuLine(surface, _land, x1, y1, x2, y2, 8);
 		}
 
 		p1 = p2;
@@ -2054,11 +2521,11 @@ void Globe::toggleRadarLines()
  */
 void Globe::resize()
 {
-	Surface *surfaces[4] = {this, _markers, _countries, _radars};
+	Surface *surfaces[5] = {this, _markers, _countries, _radars, _land};
 	int width = Options::baseXGeoscape - 64;
 	int height = Options::baseYGeoscape;
 
-	for (int i = 0; i < 4; ++i)
+	for (int i = 0; i < 5; ++i)
 	{
 		surfaces[i]->setWidth(width);
 		surfaces[i]->setHeight(height);
@@ -2069,6 +2536,8 @@ void Globe::resize()
 	_cenX = width / 2;
 	_cenY = height / 2;
 	setupRadii(width, height);
+	_landValid = false;
+	invalidateRadars();
 	invalidate();
 }
 
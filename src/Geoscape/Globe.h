@@ -44,6 +44,20 @@ class Craft;
 class Globe : public InteractiveSurface
 {
 private:
+	/**
+	 * Outline of a radar range, with its vertices kept in polar
+	 * coordinates and projected on the globe until it's rotated
+	 * or zoomed.
+	 */
+	struct RadarCircle
+	{
+		double lat, lon, radius;
+		int segments, frac;
+		bool projected;
+		std::vector<double> lon1, lat1, x, y;
+		std::vector<char> back;
+	};
+
 	static const int NUM_LANDSHADES = 48;
 	static const int NUM_SEASHADES = 72;
 	static const int NEAR_RADIUS = 25;
@@ -52,6 +66,9 @@ private:
 	static const int CITY_MARKER = 8;
 	static const double ROTATE_LONGITUDE;
 	static const double ROTATE_LATITUDE;
+	static const double SHADOW_SUN_STEP;
+	/// Rows of the globe shaded by each job of the worker pool.
+	static const int SHADOW_BAND_HEIGHT = 32;
 
 	RuleGlobe *_rules;
 	Sint16 _cenX, _cenY;
@@ -60,7 +77,15 @@ private:
 	size_t _zoom, _zoomOld, _zoomTexture;
 	SurfaceSet *_texture, *_markerSet;
 	Game *_game;
-	Surface *_markers, *_countries, *_radars;
+	Surface *_markers, *_countries, *_radars, *_land;
+	double _landLon, _landLat, _landRadius;
+	size_t _landZoom;
+	bool _landValid;
+	Cord _shadowSun;
+	std::vector<RadarCircle> _radarCircles;
+	std::vector<Uint8> _radarMask;
+	std::vector<std::pair<int, Uint8> > _radarPixels;
+	bool _radarValid;
 	bool _hover, _craft;
 	int _blink;
 	Timer *_blinkTimer, *_rotTimer;
@@ -93,8 +118,12 @@ private:
 	void cache(std::list<Polygon*> *polygons, std::list<Polygon*> *cache);
 	/// Get position of sun relative to given position in polar cords and date.
 	Cord getSunDirection(double lon, double lat) const;
-	/// Draw globe range circle.
-	void drawGlobeCircle(double lat, double lon, double radius, int segments, int frac = 1);
+	/// Adds a radar range circle to draw, reusing its outline from the last draw.
+	void addRadarCircle(std::vector<RadarCircle> &circles, double lat, double lon, double radius, int segments, int frac = 1);
+	/// Marks the pixels of the radar circles on the coverage mask.
+	void maskRadarCircle(RadarCircle &circle);
+	/// Forgets the radar coverage drawn for the old land or size.
+	void invalidateRadars();
 	/// Special "transparent" line.
 	void XuLine(Surface* surface, Surface* src, double x1, double y1, double x2, double y2, int shade);
 	/// Draw line on globe surface.
@@ -175,12 +204,14 @@ public:
 	void rotate();
 	/// Draws the whole globe.
 	void draw() override;
-	/// Draws the ocean of the globe.
+	/// Draws the ocean of the globe into the land cache.
 	void drawOcean();
-	/// Draws the land of the globe.
+	/// Draws the land of the globe into the land cache.
 	void drawLand();
-	/// Draws the shadow.
+	/// Draws the shadow over the cached land.
 	void drawShadow();
+	/// Times the shadow kernels and checks them against the shader.
+	static bool benchmarkShadow(int rounds);
 	/// Draws the radar ranges of the globe.
 	void drawRadars();
 	/// Draws the flight paths of the globe.
@@ -18,9 +18,13 @@
  */
 
 #include "FpsCounter.h"
+#include <algorithm>
 #include <cmath>
+#include <sstream>
 #include "../Engine/Action.h"
+#include "../Engine/Benchmark.h"
 #include "../Engine/Timer.h"
+#include "../Engine/Logger.h"
 #include "../Engine/Options.h"
 #include "NumberText.h"
 
@@ -34,7 +38,7 @@ namespace OpenXcom
  * @param x X position in pixels.
  * @param y Y position in pixels.
  */
-FpsCounter::FpsCounter(int width, int height, int x, int y) : Surface(width, height, x, y), _frames(0)
+FpsCounter::FpsCounter(int width, int height, int x, int y) : Surface(width, height, x, y), _frames(0), _histogram(), _slowest()
 {
 	_visible = Options::fpsCounter;
 
@@ -116,9 +120,64 @@ void FpsCounter::draw()
 	_text->blit(this->getSurface());
 }
 
-void FpsCounter::addFrame()
+/**
+ * Counts a frame that was drawn, and adds the time
+ * its parts took to the histograms while the engine
+ * sections are being timed.
+ * Buckets are under 1 ms, under 2 ms, under 4 ms and so on.
+ * @param think Time spent running the game logic since the last frame, in microseconds.
+ * @param draw Time spent drawing the states, in microseconds.
+ * @param flip Time spent putting the frame on screen, in microseconds.
+ */
+void FpsCounter::addFrame(Uint32 think, Uint32 draw, Uint32 flip)
 {
 	_frames++;
+	if (!Benchmark::sectionsEnabled)
+	{
+		return;
+	}
+	const Uint32 times[FRAME_PHASES] = { think, draw, flip };
+	for (int phase = 0; phase < FRAME_PHASES; ++phase)
+	{
+		int bucket = 0;
+		for (Uint32 limit = 1000; bucket < FRAME_BUCKETS - 1 && times[phase] >= limit; limit *= 2)
+		{
+			++bucket;
+		}
+		_histogram[phase][bucket]++;
+		_slowest[phase] = std::max(_slowest[phase], times[phase]);
+	}
+}
+
+/**
+ * Empties the frame time histograms.
+ */
+void FpsCounter::clearFrameTimes()
+{
+	std::fill(&_histogram[0][0], &_histogram[0][0] + FRAME_PHASES * FRAME_BUCKETS, 0);
+	std::fill(_slowest, _slowest + FRAME_PHASES, 0);
+}
+
+/**
+ * Logs the frame time histograms collected
+ * since they were last cleared, then clears them.
+ */
+void FpsCounter::reportFrameTimes()
+{
+	const char *names[FRAME_PHASES] = { "think", "draw", "flip" };
+	std::ostringstream ss;
+	ss << "Frame times in ms:";
+	for (int phase = 0; phase < FRAME_PHASES; ++phase)
+	{
+		ss << (phase ? ", " : " ") << names[phase] << " [";
+		for (int i = 0; i < FRAME_BUCKETS; ++i)
+		{
+			ss << (i ? " " : "") << _histogram[phase][i];
+		}
+		ss << "] max " << _slowest[phase] / 1000.0;
+	}
+	Log(LOG_INFO) << ss.str();
+	clearFrameTimes();
 }
 
 }
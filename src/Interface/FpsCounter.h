@@ -26,16 +26,25 @@ class NumberText;
 class Timer;
 class Action;
 
+/// Parts of a frame timed by the game loop.
+enum FramePhase { FRAME_THINK, FRAME_DRAW, FRAME_FLIP, FRAME_PHASES };
+
 /**
  * Counts the amount of frames each second
  * and displays them in a NumberText surface.
+ * Also keeps a histogram of how long each part of
+ * the frames took while the engine sections are timed.
  */
 class FpsCounter : public Surface
 {
 private:
+	/// Histogram buckets, each twice as long as the last, starting at 1 ms.
+	static const int FRAME_BUCKETS = 8;
 	NumberText *_text;
 	Timer *_timer;
 	int _frames;
+	int _histogram[FRAME_PHASES][FRAME_BUCKETS];
+	Uint32 _slowest[FRAME_PHASES];
 public:
 	/// Creates a new FPS counter linked to a game.
 	FpsCounter(int width, int height, int x, int y);
@@ -53,7 +62,12 @@ public:
 	void update();
 	/// Draws the FPS counter.
 	void draw() override;
-	void addFrame();
+	/// Counts a frame and how long its parts took.
+	void addFrame(Uint32 think, Uint32 draw, Uint32 flip);
+	/// Empties the frame time histograms.
+	void clearFrameTimes();
+	/// Logs and empties the frame time histograms.
+	void reportFrameTimes();
 };
 
 }
@@ -30,11 +30,15 @@
 #include "../Engine/Font.h"
 #include "../Engine/Timer.h"
 #include "../Engine/CrossPlatform.h"
+#include "../Engine/BlitKernels.h"
 #include "../Interface/FpsCounter.h"
 #include "../Interface/Cursor.h"
 #include "../Interface/Text.h"
 #include "MainMenuState.h"
 #include "CutsceneState.h"
+#include "../Geoscape/GeoscapeBenchmarkState.h"
+#include "../Geoscape/Globe.h"
+#include "../Battlescape/BattlescapeBenchmarkState.h"
 #include <SDL_mixer.h>
 #include <SDL_thread.h>
 
@@ -174,6 +178,32 @@ void StartState::think()
 	case LOADING_SUCCESSFUL:
 		CrossPlatform::flashWindow();
 		Log(LOG_INFO) << "OpenXcom started successfully!";
+		if (Options::getBenchmark() == "geoscape")
+		{
+			int days = Options::getBenchmarkLength() > 0 ? Options::getBenchmarkLength() : 30;
+			_game->setState(new GeoscapeBenchmarkState(Options::getBenchmarkSave(), days, Options::getBenchmarkSeed()));
+			break;
+		}
+		if (Options::getBenchmark() == "battlescape")
+		{
+			int turns = Options::getBenchmarkLength() > 0 ? Options::getBenchmarkLength() : 100;
+			_game->setState(new BattlescapeBenchmarkState(Options::getBenchmarkSave(), turns, Options::getBenchmarkSeed()));
+			break;
+		}
+		if (Options::getBenchmark() == "blit")
+		{
+			int rounds = Options::getBenchmarkLength() > 0 ? Options::getBenchmarkLength() : 1000;
+			BlitKernels::benchmark(rounds);
+			_game->quit();
+			break;
+		}
+		if (Options::getBenchmark() == "globe")
+		{
+			int rounds = Options::getBenchmarkLength() > 0 ? Options::getBenchmarkLength() : 100;
+			Globe::benchmarkShadow(rounds);
+			_game->quit();
+			break;
+		}
 		_game->setState(new GoToMainMenuState(true));
 		if (_oldMaster != Options::getActiveMaster() && Options::playIntro)
 		{
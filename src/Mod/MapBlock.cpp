@@ -21,6 +21,7 @@
 #include "MapBlock.h"
 #include "../Battlescape/Position.h"
 #include "../Engine/Exception.h"
+#include "../Engine/FileMap.h"
 
 namespace YAML
 {
@@ -57,7 +58,7 @@ namespace OpenXcom
 /**
  * MapBlock construction.
  */
-MapBlock::MapBlock(const std::string &name): _name(name), _size_x(10), _size_y(10), _size_z(4)
+MapBlock::MapBlock(const std::string &name): _name(name), _size_x(10), _size_y(10), _size_z(4), _mapLoaded(false), _routesLoaded(false)
 {
 	_groups.push_back(0);
 }
@@ -203,4 +204,69 @@ const std::map<std::string, std::pair<int, int> > *MapBlock::getItemsFuseTimers(
 	return &_itemsFuseTimer;
 }
 
+/**
+ * Gets the contents of the MAP file of this block: the size of
+ * the block in 3 bytes, followed by 4 bytes of terrain objects
+ * per tile. The file is only read and checked the first time,
+ * then kept for every map generated with this block.
+ * @return The MAP data.
+ * @sa http://www.ufopaedia.org/index.php?title=MAPS
+ */
+const std::vector<unsigned char> &MapBlock::getMapData()
+{
+	if (!_mapLoaded)
+	{
+		std::string filename = "MAPS/" + _name + ".MAP";
+		auto mapFile = FileMap::getIStream(filename);
+
+		std::vector<unsigned char> data(3);
+		if (!mapFile->read((char*)&data[0], 3))
+		{
+			throw Exception("Invalid MAP file: " + filename);
+		}
+		unsigned char value[4];
+		while (mapFile->read((char*)&value, sizeof(value)))
+		{
+			data.insert(data.end(), value, value + sizeof(value));
+		}
+		if (!mapFile->eof())
+		{
+			throw Exception("Invalid MAP file: " + filename);
+		}
+		_mapData.swap(data);
+		_mapLoaded = true;
+	}
+	return _mapData;
+}
+
+/**
+ * Gets the contents of the RMP file of this block: 24 bytes
+ * per node. The file is only read and checked the first time,
+ * then kept for every map generated with this block.
+ * @return The RMP data.
+ * @sa http://www.ufopaedia.org/index.php?title=ROUTES
+ */
+const std::vector<unsigned char> &MapBlock::getRouteData()
+{
+	if (!_routesLoaded)
+	{
+		std::string filename = "ROUTES/" + _name + ".RMP";
+		auto routeFile = FileMap::getIStream(filename);
+
+		std::vector<unsigned char> data;
+		unsigned char value[24];
+		while (routeFile->read((char*)&value, sizeof(value)))
+		{
+			data.insert(data.end(), value, value + sizeof(value));
+		}
+		if (!routeFile->eof())
+		{
+			throw Exception("Invalid RMP file: " + filename);
+		}
+		_routeData.swap(data);
+		_routesLoaded = true;
+	}
+	return _routeData;
+}
+
 }
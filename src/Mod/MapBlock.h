@@ -52,6 +52,8 @@ private:
 	std::map<std::string, std::vector<Position> > _items;
 	std::vector<RandomizedItems> _randomizedItems;
 	std::map<std::string, std::pair<int, int> > _itemsFuseTimer;
+	std::vector<unsigned char> _mapData, _routeData;
+	bool _mapLoaded, _routesLoaded;
 public:
 	MapBlock(const std::string &name);
 	~MapBlock();
@@ -77,6 +79,10 @@ public:
 	const std::vector<RandomizedItems> *getRandomizedItems() const;
 	/// Gets the fuse timer for any items that belong in this map block.
 	const std::map<std::string, std::pair<int, int> > *getItemsFuseTimers() const;
+	/// Gets the contents of the mapblock's MAP file.
+	const std::vector<unsigned char> &getMapData();
+	/// Gets the contents of the mapblock's RMP file.
+	const std::vector<unsigned char> &getRouteData();
 
 };
 
@@ -36,6 +36,7 @@
 #include "../Engine/Sound.h"
 #include "../Interface/TextButton.h"
 #include "../Interface/Window.h"
+#include "MapData.h"
 #include "MapDataSet.h"
 #include "RuleMusic.h"
 #include "../Engine/ShaderDraw.h"
@@ -43,6 +44,7 @@
 #include "../Engine/Exception.h"
 #include "../Engine/Logger.h"
 #include "../Engine/ScriptBind.h"
+#include "../Engine/ScriptProfiler.h"
 #include "../Engine/Collections.h"
 #include "SoundDefinition.h"
 #include "ExtraSprites.h"
@@ -742,6 +744,35 @@ T *Mod::getRule(const std::string &id, const std::string &name, const std::map<s
 	}
 }
 
+/**
+ * Returns the rule element with the specified ID, through the hashed
+ * registry of its type once it's built, or the map while still loading.
+ * @param id String ID of the rule element.
+ * @param name Human-readable name of the rule type.
+ * @param map Map associated to the rule type.
+ * @param registry Registry of the rule type.
+ * @param error Throw an error if not found.
+ * @return Pointer to the rule element, or NULL if not found.
+ */
+template <typename T>
+T *Mod::getRule(const std::string &id, const std::string &name, const std::map<std::string, T*> &map, const RuleRegistry<T> &registry, bool error) const
+{
+	if (!registry.isBuilt())
+	{
+		return getRule(id, name, map, error);
+	}
+	if (id.empty())
+	{
+		return 0;
+	}
+	T *rule = registry.find(id);
+	if (rule == 0 && error)
+	{
+		throw Exception(name + " " + id + " not found");
+	}
+	return rule;
+}
+
 /**
  * Returns a specific font from the mod.
  * @param name Name of the font.
@@ -1682,6 +1713,7 @@ void Mod::loadAll()
 		{
 			_modCurrent = &_modData.at(i);
 			_scriptGlobal->setMod((int)_modCurrent->offset);
+			ScriptProfiler::setCurrentMod(mods[i].first);
 			loadMod(mods[i].second, parser);
 		}
 		catch (Exception &e)
@@ -1694,6 +1726,7 @@ void Mod::loadAll()
 	//back master
 	_modCurrent = &_modData.at(0);
 	_scriptGlobal->endLoad();
+	ScriptProfiler::setCurrentMod("");
 
 	// post-processing item categories
 	std::map<std::string, std::string> replacementRules;
@@ -1784,6 +1817,28 @@ void Mod::loadAll()
 	Collections::sortVectorMakeUnique(_craftWeaponStorageItemsCache);
 
 
+	// dense research indices for the saved game, in research map order
+	{
+		int index = 0;
+		for (auto& r : _research)
+		{
+			r.second->setIndex(index++);
+		}
+		// the linked rules are all owned by _research, so it is safe to update them in place
+		for (auto& r : _research)
+		{
+			for (auto* dep : r.second->getDependencies())
+			{
+				const_cast<RuleResearch*>(dep)->addDependent(r.second, false);
+			}
+			for (auto* req : r.second->getRequirements())
+			{
+				const_cast<RuleResearch*>(req)->addDependent(r.second, true);
+			}
+		}
+	}
+
+
 	// check unique listOrder
 	{
 		std::vector<int> tmp;
@@ -1862,6 +1917,8 @@ void Mod::loadAll()
 
 
 	sortLists();
+	buildRegistries();
+	indexResearchDependents();
 	loadExtraResources();
 	modResources();
 }
@@ -3070,7 +3127,7 @@ const std::vector<std::string> &Mod::getRegionsList() const
  */
 RuleBaseFacility *Mod::getBaseFacility(const std::string &id, bool error) const
 {
-	return getRule(id, "Facility", _facilities, error);
+	return getRule(id, "Facility", _facilities, _facilitiesRegistry, error);
 }
 
 /**
@@ -3090,7 +3147,7 @@ const std::vector<std::string> &Mod::getBaseFacilitiesList() const
  */
 RuleCraft *Mod::getCraft(const std::string &id, bool error) const
 {
-	return getRule(id, "Craft", _crafts, error);
+	return getRule(id, "Craft", _crafts, _craftsRegistry, error);
 }
 
 /**
@@ -3162,7 +3219,7 @@ RuleItem *Mod::getItem(const std::string &id, bool error) const
 	{
 		return 0;
 	}
-	return getRule(id, "Item", _items, error);
+	return getRule(id, "Item", _items, _itemsRegistry, error);
 }
 
 /**
@@ -3175,6 +3232,21 @@ const std::vector<std::string> &Mod::getItemsList() const
 	return _itemsIndex;
 }
 
+/**
+ * Returns the item set off by stepping on a death trap floor,
+ * the STR_DEATH_TRAP_<type> item looked up once after loading.
+ * @param specialType Special type of the floor tile.
+ * @return Rules for the item, or 0 if there's none.
+ */
+RuleItem *Mod::getDeathTrap(int specialType) const
+{
+	if (specialType < 0 || specialType >= (int)_deathTraps.size())
+	{
+		return 0;
+	}
+	return _deathTraps[specialType];
+}
+
 /**
  * Returns the rules for the specified UFO.
  * @param id UFO type.
@@ -3252,7 +3324,7 @@ RuleSkill *Mod::getSkill(const std::string &name, bool error) const
  */
 RuleSoldier *Mod::getSoldier(const std::string &name, bool error) const
 {
-	return getRule(name, "Soldier", _soldiers, error);
+	return getRule(name, "Soldier", _soldiers, _soldiersRegistry, error);
 }
 
 /**
@@ -3291,7 +3363,7 @@ const std::map<std::string, RuleCommendations *> &Mod::getCommendationsList() co
  */
 Unit *Mod::getUnit(const std::string &name, bool error) const
 {
-	return getRule(name, "Unit", _units, error);
+	return getRule(name, "Unit", _units, _unitsRegistry, error);
 }
 
 /**
@@ -3384,7 +3456,7 @@ const std::vector<std::string> &Mod::getDeploymentsList() const
  */
 Armor *Mod::getArmor(const std::string &name, bool error) const
 {
-	return getRule(name, "Armor", _armors, error);
+	return getRule(name, "Armor", _armors, _armorsRegistry, error);
 }
 
 /**
@@ -3544,7 +3616,7 @@ const std::vector<std::string> &Mod::getInvsList() const
  */
 RuleResearch *Mod::getResearch(const std::string &id, bool error) const
 {
-	return getRule(id, "Research", _research, error);
+	return getRule(id, "Research", _research, _researchRegistry, error);
 }
 
 /**
@@ -3586,6 +3658,23 @@ const std::vector<std::string> &Mod::getResearchList() const
 	return _researchIndex;
 }
 
+/**
+ * Gets the rules that list a research project in their requirements,
+ * so finishing it only needs to check those instead of every rule.
+ * @param research The research project.
+ * @return Manufacture, items, crafts and facilities in list order.
+ */
+const ResearchDependents &Mod::getResearchDependents(const RuleResearch *research) const
+{
+	static const ResearchDependents empty;
+	size_t index = research->getIndex();
+	if (index < _researchDependentsCache.size())
+	{
+		return _researchDependentsCache[index];
+	}
+	return empty;
+}
+
 /**
  * Returns the rules for the specified manufacture project.
  * @param id Manufacture project type.
@@ -3593,7 +3682,7 @@ const std::vector<std::string> &Mod::getResearchList() const
  */
 RuleManufacture *Mod::getManufacture (const std::string &id, bool error) const
 {
-	return getRule(id, "Manufacture", _manufacture, error);
+	return getRule(id, "Manufacture", _manufacture, _manufactureRegistry, error);
 }
 
 /**
@@ -4018,6 +4107,113 @@ void Mod::sortLists()
 	std::sort(_soldiersIndex.begin(), _soldiersIndex.end(), compareRule<RuleSoldier>(this, (compareRule<RuleSoldier>::RuleLookup) & Mod::getSoldier));
 }
 
+/**
+ * Hashes the rules that are looked up by name all the time,
+ * from the battlescape and geoscape loops and while loading saves,
+ * so those lookups are a hash instead of a tree search. Also finds
+ * the death trap items, so they don't need a name built per step.
+ */
+void Mod::buildRegistries()
+{
+	_itemsRegistry.build(_items);
+	_armorsRegistry.build(_armors);
+	_unitsRegistry.build(_units);
+	_soldiersRegistry.build(_soldiers);
+	_researchRegistry.build(_research);
+	_manufactureRegistry.build(_manufacture);
+	_craftsRegistry.build(_crafts);
+	_facilitiesRegistry.build(_facilities);
+
+	_deathTraps.clear();
+	const std::string deathTrap = "STR_DEATH_TRAP_";
+	for (auto &pair : _items)
+	{
+		const std::string &type = pair.first;
+		if (pair.second == 0 || type.compare(0, deathTrap.size(), deathTrap) != 0)
+		{
+			continue;
+		}
+		const std::string number = type.substr(deathTrap.size());
+		if (number.empty() || number.size() > 6 || number.find_first_not_of("0123456789") != std::string::npos || (number[0] == '0' && number.size() > 1))
+		{
+			continue;
+		}
+		size_t specialType = std::stoi(number);
+		if (specialType < DEATH_TRAPS)
+		{
+			continue;
+		}
+		if (specialType >= _deathTraps.size())
+		{
+			_deathTraps.resize(specialType + 1, 0);
+		}
+		_deathTraps[specialType] = pair.second;
+	}
+}
+
+/**
+ * Builds the index of rules that require each research topic,
+ * walking the sorted lists so every index keeps the list order.
+ * A rule listing the same topic twice is only added once.
+ */
+void Mod::indexResearchDependents()
+{
+	auto add = [](auto &list, auto *rule)
+	{
+		if (list.empty() || list.back() != rule)
+		{
+			list.push_back(rule);
+		}
+	};
+
+	_researchDependentsCache.clear();
+	_researchDependentsCache.resize(_research.size());
+	for (auto &name : _manufactureIndex)
+	{
+		RuleManufacture *rule = getManufacture(name);
+		for (auto *research : rule->getRequirements())
+		{
+			add(_researchDependentsCache[research->getIndex()].manufacture, rule);
+		}
+	}
+	for (auto &name : _itemsIndex)
+	{
+		RuleItem *rule = getItem(name);
+		for (auto *research : rule->getRequirements())
+		{
+			add(_researchDependentsCache[research->getIndex()].items, rule);
+		}
+		for (auto *research : rule->getBuyRequirements())
+		{
+			add(_researchDependentsCache[research->getIndex()].items, rule);
+		}
+	}
+	for (auto &name : _craftsIndex)
+	{
+		RuleCraft *rule = getCraft(name);
+		for (auto &req : rule->getRequirements())
+		{
+			const RuleResearch *research = getResearch(req);
+			if (research)
+			{
+				add(_researchDependentsCache[research->getIndex()].crafts, rule);
+			}
+		}
+	}
+	for (auto &name : _facilitiesIndex)
+	{
+		RuleBaseFacility *rule = getBaseFacility(name);
+		for (auto &req : rule->getRequirements())
+		{
+			const RuleResearch *research = getResearch(req);
+			if (research)
+			{
+				add(_researchDependentsCache[research->getIndex()].facilities, rule);
+			}
+		}
+	}
+}
+
 /**
  * Gets the research-requirements for Psi-Lab (it's a cache for psiStrengthEval)
  */
@@ -18,6 +18,7 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <map>
+#include <unordered_map>
 #include <vector>
 #include <string>
 #include <bitset>
@@ -120,6 +121,56 @@ struct ModData
 	size_t size;
 };
 
+/**
+ * Hash table of all the rules of one type, built once the mod
+ * is loaded, so rules are found by name without a tree search.
+ */
+template <typename T>
+class RuleRegistry
+{
+	std::unordered_map<std::string, T*> _rules;
+	bool _built = false;
+public:
+	/// Adds all the rules of a map.
+	void build(const std::map<std::string, T*> &map)
+	{
+		_rules.clear();
+		_rules.reserve(map.size());
+		for (auto &pair : map)
+		{
+			if (pair.second != 0)
+			{
+				_rules[pair.first] = pair.second;
+			}
+		}
+		_built = true;
+	}
+	/// Was the registry built yet?
+	bool isBuilt() const { return _built; }
+	/// Gets a rule by name, or null if there's none.
+	T *find(const std::string &name) const
+	{
+		auto i = _rules.find(name);
+		return i != _rules.end() ? i->second : 0;
+	}
+};
+
+/**
+ * Rules that list a research topic in their requirements,
+ * in the same order as the lists of the mod.
+ */
+struct ResearchDependents
+{
+	/// Manufacture projects that require the topic.
+	std::vector<RuleManufacture*> manufacture;
+	/// Items that require the topic to be used or bought.
+	std::vector<RuleItem*> items;
+	/// Crafts that require the topic.
+	std::vector<RuleCraft*> crafts;
+	/// Base facilities that require the topic.
+	std::vector<RuleBaseFacility*> facilities;
+};
+
 /**
  * Helper exception representing the final message with all the required context for the end user to fix the errors in rulesets
  */
@@ -286,6 +337,16 @@ private:
 	std::vector<const Armor*> _armorsForSoldiersCache;
 	std::vector<const RuleItem*> _armorStorageItemsCache;
 	std::vector<const RuleItem*> _craftWeaponStorageItemsCache;
+	std::vector<ResearchDependents> _researchDependentsCache;
+	RuleRegistry<RuleItem> _itemsRegistry;
+	RuleRegistry<Armor> _armorsRegistry;
+	RuleRegistry<Unit> _unitsRegistry;
+	RuleRegistry<RuleSoldier> _soldiersRegistry;
+	RuleRegistry<RuleResearch> _researchRegistry;
+	RuleRegistry<RuleManufacture> _manufactureRegistry;
+	RuleRegistry<RuleCraft> _craftsRegistry;
+	RuleRegistry<RuleBaseFacility> _facilitiesRegistry;
+	std::vector<RuleItem*> _deathTraps;
 
 	size_t _surfaceOffsetBigobs = 0;
 	size_t _surfaceOffsetFloorob = 0;
@@ -307,6 +368,9 @@ private:
 	/// Gets a ruleset element.
 	template <typename T>
 	T *getRule(const std::string &id, const std::string &name, const std::map<std::string, T*> &map, bool error) const;
+	/// Gets a ruleset element through its registry, once it's built.
+	template <typename T>
+	T *getRule(const std::string &id, const std::string &name, const std::map<std::string, T*> &map, const RuleRegistry<T> &registry, bool error) const;
 	/// Gets a random music. This is private to prevent access, use playMusic(name, true) instead.
 	Music *getRandomMusic(const std::string &name) const;
 	/// Gets a particular sound set. This is private to prevent access, use getSound(name, id) instead.
@@ -331,6 +395,10 @@ private:
 	void modResources();
 	/// Sorts all our lists according to their weight.
 	void sortLists();
+	/// Builds the index of rules unlocked by each research topic.
+	void indexResearchDependents();
+	/// Builds the registries of the rules looked up most often.
+	void buildRegistries();
 public:
 	static int DOOR_OPEN;
 	static int SLIDING_DOOR_OPEN;
@@ -569,6 +637,8 @@ public:
 	RuleItem *getItem(const std::string &id, bool error = false) const;
 	/// Gets the available items.
 	const std::vector<std::string> &getItemsList() const;
+	/// Gets the item set off by a death trap floor.
+	RuleItem *getDeathTrap(int specialType) const;
 	/// Gets the ruleset for a UFO type.
 	RuleUfo *getUfo(const std::string &id, bool error = false) const;
 	/// Gets the available UFOs.
@@ -843,6 +913,8 @@ public:
 	const std::map<std::string, RuleResearch *> &getResearchMap() const;
 	/// Gets the list of all research projects.
 	const std::vector<std::string> &getResearchList() const;
+	/// Gets the rules that require a research project.
+	const ResearchDependents &getResearchDependents(const RuleResearch *research) const;
 	/// Gets the ruleset for a specific manufacture project.
 	RuleManufacture *getManufacture (const std::string &id, bool error = false) const;
 	/// Gets the list of all manufacture projects.
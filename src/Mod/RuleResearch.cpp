@@ -25,7 +25,7 @@
 namespace OpenXcom
 {
 
-RuleResearch::RuleResearch(const std::string &name) : _name(name), _cost(0), _points(0), _sequentialGetOneFree(false), _needItem(false), _destroyItem(false), _listOrder(0)
+RuleResearch::RuleResearch(const std::string &name) : _name(name), _cost(0), _points(0), _sequentialGetOneFree(false), _needItem(false), _destroyItem(false), _listOrder(0), _index(-1)
 {
 }
 
@@ -108,6 +108,25 @@ void RuleResearch::afterLoad(const Mod* mod)
 	Collections::removeAll(_getOneFreeProtectedName);
 }
 
+/**
+ * Adds a research that lists this one in its dependencies
+ * or requirements, so discovering this one can tell which
+ * topics got closer to being available.
+ * @param research The dependent research.
+ * @param requirement True if this one is in its requirements, false if in its dependencies.
+ */
+void RuleResearch::addDependent(const RuleResearch* research, bool requirement)
+{
+	if (requirement)
+	{
+		_requiredBy.push_back(research);
+	}
+	else
+	{
+		_dependents.push_back(research);
+	}
+}
+
 /**
  * Gets the cost of this ResearchProject.
  * @return The cost of this ResearchProject (in man/day).
@@ -51,7 +51,8 @@ class RuleResearch
 	std::map<std::string, std::vector<std::string> > _getOneFreeProtectedName;
 	std::map<const RuleResearch*, std::vector<const RuleResearch*> > _getOneFreeProtected;
 	bool _needItem, _destroyItem;
-	int _listOrder;
+	int _listOrder, _index;
+	std::vector<const RuleResearch*> _dependents, _requiredBy;
 public:
 	static const int RESEARCH_STATUS_NEW = 0;
 	static const int RESEARCH_STATUS_NORMAL = 1;
@@ -62,6 +63,10 @@ public:
 	void load(const YAML::Node& node, Mod* mod, int listOrder);
 	/// Cross link with other rules.
 	void afterLoad(const Mod* mod);
+	/// Sets the position of this research among all research.
+	void setIndex(int index) { _index = index; }
+	/// Adds a research that has this one as a dependency or requirement.
+	void addDependent(const RuleResearch* research, bool requirement);
 
 	/// Gets time needed to discover this ResearchProject.
 	int getCost() const;
@@ -99,6 +104,12 @@ public:
 	const std::string & getSpawnedItem() const;
 	/// Gets the geoscape event to spawn when this topic is researched.
 	const std::string& getSpawnedEvent() const { return _spawnedEvent; }
+	/// Gets the position of this research among all research, in name order.
+	int getIndex() const { return _index; }
+	/// Gets the research that has this one as a dependency.
+	const std::vector<const RuleResearch*> &getDependents() const { return _dependents; }
+	/// Gets the research that has this one as a requirement.
+	const std::vector<const RuleResearch*> &getRequiredBy() const { return _requiredBy; }
 };
 
 }
@@ -54,7 +54,7 @@ namespace OpenXcom
  * Initializes an empty base.
  * @param mod Pointer to mod.
  */
-Base::Base(const Mod *mod) : Target(), _mod(mod), _scientists(0), _engineers(0), _inBattlescape(false), _retaliationTarget(false), _fakeUnderwater(false)
+Base::Base(const Mod *mod) : Target(), _mod(mod), _scientists(0), _engineers(0), _inBattlescape(false), _retaliationTarget(false), _fakeUnderwater(false), _detectionProfileDirty(true)
 {
 	_items = new ItemContainer();
 }
@@ -392,10 +392,13 @@ int Base::getMarker() const
 
 /**
  * Returns the list of facilities in the base.
+ * Callers can add, remove or finish facilities through it,
+ * so this invalidates the cached radar coverage.
  * @return Pointer to the facility list.
  */
 std::vector<BaseFacility*> *Base::getFacilities()
 {
+	_detectionProfileDirty = true;
 	return &_facilities;
 }
 
@@ -455,6 +458,60 @@ void Base::setEngineers(int engineers)
 	 _engineers = engineers;
 }
 
+/**
+ * Returns the radar coverage of the base, summarizing all
+ * the finished radar facilities so detection doesn't need
+ * to walk the facility list for every UFO.
+ * @return Detection profile of the base.
+ */
+const BaseDetectionProfile &Base::getDetectionProfile() const
+{
+	if (!_detectionProfileDirty)
+	{
+		return _detectionProfile;
+	}
+
+	BaseDetectionProfile &profile = _detectionProfile;
+	profile = BaseDetectionProfile();
+	std::vector<std::pair<int, int> > radars;
+	for (const BaseFacility *fac : _facilities)
+	{
+		if (fac->getBuildTime() != 0)
+		{
+			continue;
+		}
+		int range = fac->getRules()->getRadarRange();
+		int chance = fac->getRules()->getRadarChance();
+		if (fac->getRules()->isHyperwave())
+		{
+			profile.hyperwave.push_back(std::make_pair(range, chance));
+			profile.hyperwaveMaxRange = std::max(profile.hyperwaveMaxRange, range);
+		}
+		else
+		{
+			if (chance != 0)
+			{
+				radars.push_back(std::make_pair(range, chance));
+			}
+			profile.radarMaxRange = std::max(profile.radarMaxRange, range);
+		}
+	}
+
+	std::sort(radars.begin(), radars.end());
+	profile.radarChance.resize(radars.size() + 1, 0);
+	for (int i = (int)radars.size() - 1; i >= 0; --i)
+	{
+		profile.radarChance[i] = profile.radarChance[i + 1] + radars[i].second;
+	}
+	for (auto &r : radars)
+	{
+		profile.radarRange.push_back(r.first);
+	}
+
+	_detectionProfileDirty = false;
+	return profile;
+}
+
 /**
  * Returns if a certain target is covered by the base's
  * radar range, taking in account the range and chance.
@@ -464,43 +521,32 @@ void Base::setEngineers(int engineers)
  */
 UfoDetection Base::detect(const Ufo *target, bool alreadyTracked) const
 {
+	const BaseDetectionProfile &profile = getDetectionProfile();
 	auto distance = XcomDistance(getDistance(target));
 	auto hyperwave = false;
-	auto hyperwave_max_range = 0;
+	auto hyperwave_max_range = profile.hyperwaveMaxRange;
 	auto hyperwave_chance = 0;
-	auto radar_max_range = 0;
+	auto radar_max_range = profile.radarMaxRange;
 	auto radar_chance = 0;
 
-	for (std::vector<BaseFacility*>::const_iterator i = _facilities.begin(); i != _facilities.end(); ++i)
+	// hyper-wave decoders roll individually, in facility order
+	for (auto &h : profile.hyperwave)
 	{
-		if ((*i)->getBuildTime() != 0)
-		{
-			continue;
-		}
-		if ((*i)->getRules()->getRadarRange() >= distance)
+		if (h.first >= distance)
 		{
-			int radarChance = (*i)->getRules()->getRadarChance();
-			if ((*i)->getRules()->isHyperwave())
+			int radarChance = h.second;
+			if (radarChance == 100 || RNG::percent(radarChance))
 			{
-				if (radarChance == 100 || RNG::percent(radarChance))
-				{
-					hyperwave = true;
-				}
-				hyperwave_chance += radarChance;
-			}
-			else
-			{
-				radar_chance += radarChance;
+				hyperwave = true;
 			}
+			hyperwave_chance += radarChance;
 		}
-		if ((*i)->getRules()->isHyperwave())
-		{
-			hyperwave_max_range = std::max(hyperwave_max_range, (*i)->getRules()->getRadarRange());
-		}
-		else
-		{
-			radar_max_range = std::max(radar_max_range, (*i)->getRules()->getRadarRange());
-		}
+	}
+
+	// conventional radars just sum the chances of all radars in range
+	{
+		auto band = std::lower_bound(profile.radarRange.begin(), profile.radarRange.end(), distance);
+		radar_chance = profile.radarChance[band - profile.radarRange.begin()];
 	}
 
 	auto detectionChance = 0;
@@ -1333,14 +1379,7 @@ const std::vector<Production *> & Base::getProductions() const
  */
 bool Base::getHyperDetection() const
 {
-	for (std::vector<BaseFacility*>::const_iterator i = _facilities.begin(); i != _facilities.end(); ++i)
-	{
-		if ((*i)->getRules()->isHyperwave() && (*i)->getBuildTime() == 0)
-		{
-			return true;
-		}
-	}
-	return false;
+	return !getDetectionProfile().hyperwave.empty();
 }
 
 /**
@@ -1444,7 +1483,8 @@ int Base::getUsedContainment(int prisonType) const
 {
 	int total = 0;
 	RuleItem *rule = 0;
-	for (std::map<std::string, int>::iterator i = _items->getContents()->begin(); i != _items->getContents()->end(); ++i)
+	const ItemContainer *items = _items;
+	for (std::map<std::string, int>::const_iterator i = items->getContents()->begin(); i != items->getContents()->end(); ++i)
 	{
 		rule = _mod->getItem((i)->first, true);
 		if (rule->isAlien() && rule->getPrisonType() == prisonType)
@@ -1705,6 +1745,7 @@ void Base::damageFacilities(Ufo *ufo)
 int Base::damageFacility(BaseFacility *toBeDamaged)
 {
 	int result = 0;
+	_detectionProfileDirty = true;
 
 	// 1. Create the new "damaged facility" first, so that when we destroy the original facility we don't lose "too much"
 	if (toBeDamaged->getRules()->getDestroyedFacility())
@@ -2031,6 +2072,7 @@ void Base::destroyFacility(std::vector<BaseFacility*>::iterator facility)
 	_destroyedFacilitiesCache[(*facility)->getRules()] += 1;
 	delete *facility;
 	_facilities.erase(facility);
+	_detectionProfileDirty = true;
 }
 
 /**
@@ -79,6 +79,23 @@ struct BaseSumDailyRecovery
 	float SickBayAbsoluteBonus = 0.0f;
 };
 
+/**
+ * Radar coverage of a base, derived from its finished facilities.
+ */
+struct BaseDetectionProfile
+{
+	/// Ranges of the conventional radars, in ascending order.
+	std::vector<int> radarRange;
+	/// Sum of the chances of all conventional radars with at least the matching range (one extra zero entry at the end).
+	std::vector<int> radarChance;
+	/// Range and chance of each hyper-wave decoder, in facility order.
+	std::vector<std::pair<int, int> > hyperwave;
+	/// Longest conventional radar range.
+	int radarMaxRange = 0;
+	/// Longest hyper-wave decoder range.
+	int hyperwaveMaxRange = 0;
+};
+
 /**
  * Represents a player base on the globe.
  * Bases can contain facilities, personnel, crafts and equipment.
@@ -103,7 +120,11 @@ private:
 	std::vector<Vehicle*> _vehiclesFromBase;
 	std::vector<BaseFacility*> _defenses;
 	std::map<const RuleBaseFacility*, int> _destroyedFacilitiesCache;
+	mutable BaseDetectionProfile _detectionProfile;
+	mutable bool _detectionProfileDirty;
 
+	/// Gets the radar coverage of the base, rebuilding it if the facilities changed.
+	const BaseDetectionProfile &getDetectionProfile() const;
 	using Target::load;
 public:
 	/// Creates a new base.
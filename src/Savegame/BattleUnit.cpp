@@ -20,6 +20,7 @@
 #include "BattleItem.h"
 #include <sstream>
 #include <algorithm>
+#include "../Engine/BlitKernels.h"
 #include "../Engine/Surface.h"
 #include "../Engine/Script.h"
 #include "../Engine/ScriptBind.h"
@@ -634,6 +635,7 @@ void BattleUnit::load(const YAML::Node &node, const Mod *mod, const ScriptGlobal
 		{
 			_recolor.push_back(std::make_pair(p[i][0].as<int>(), p[i][1].as<int>()));
 		}
+		updateRecolorTable();
 	}
 	_mindControllerID = node["mindControllerID"].as<int>(_mindControllerID);
 	_summonedPlayerUnit = node["summonedPlayerUnit"].as<bool>(_summonedPlayerUnit);
@@ -765,6 +767,29 @@ void BattleUnit::setRecolor(int basicLook, int utileLook, int rankLook)
 			_recolor.push_back(std::make_pair(colors[i].first << 4, colors[i].second));
 		}
 	}
+	updateRecolorTable();
+}
+
+/**
+ * Prepare what recolor gives for every pixel, so recolor
+ * scripts don't have to search the recolor values per pixel.
+ */
+void BattleUnit::updateRecolorTable()
+{
+	for (int pixel = 0; pixel < 256; ++pixel)
+	{
+		const int g = pixel & helper::ColorGroup;
+		const int s = pixel & helper::ColorShade;
+		_recolorTable[pixel] = pixel;
+		for (auto& p : _recolor)
+		{
+			if (g == p.first)
+			{
+				_recolorTable[pixel] = s + p.second;
+				break;
+			}
+		}
+	}
 }
 
 /**
@@ -2901,6 +2926,11 @@ void BattleUnit::setTile(Tile *tile, SavedBattleGame *saveBattleGame)
 		return;
 	}
 
+	if (saveBattleGame)
+	{
+		saveBattleGame->invalidateUnitGrid();
+	}
+
 	auto armorSize = _armor->getSize() - 1;
 	// Reset tiles moved from.
 	if (_tile)
@@ -5054,6 +5084,11 @@ void getRecolorScript(const BattleUnit *bu, int &pixel)
 {
 	if (bu)
 	{
+		if ((unsigned)pixel < 256u)
+		{
+			pixel = bu->getRecolorTable()[pixel];
+			return;
+		}
 		const auto& vec = bu->getRecolor();
 		const int g = pixel & helper::ColorGroup;
 		const int s = pixel & helper::ColorShade;
@@ -5229,6 +5264,13 @@ struct burnShadeScript
 {
 	static RetEnum func(int &curr, int burn, int shade)
 	{
+		const Uint8 *table = burn ? nullptr : BlitKernels::getShadeTable(shade);
+		if (table)
+		{
+			const Uint8 pixel = curr;
+			curr = pixel ? table[pixel] : 0;
+			return RetContinue;
+		}
 		Uint8 d = curr;
 		Uint8 s = curr;
 		helper::BurnShade::func(d, s, burn, shade);
@@ -17,6 +17,7 @@
  * You should have received a copy of the GNU General Public License
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <array>
 #include <vector>
 #include <string>
 #include <unordered_set>
@@ -164,6 +165,7 @@ private:
 	bool _disableIndicators;
 	MovementType _movementType;
 	std::vector<std::pair<Uint8, Uint8> > _recolor;
+	std::array<Uint16, 256> _recolorTable;
 	bool _capturable;
 	ScriptValues<BattleUnit> _scriptValues;
 
@@ -266,6 +268,10 @@ public:
 	UnitFaction getFaction() const;
 	/// Gets unit sprite recolors values.
 	const std::vector<std::pair<Uint8, Uint8> > &getRecolor() const;
+	/// Gets unit sprite recolors values for every pixel.
+	const std::array<Uint16, 256> &getRecolorTable() const { return _recolorTable; }
+	/// Rebuilds the recolor values for every pixel.
+	void updateRecolorTable();
 	/// Kneel down.
 	void kneel(bool kneeled);
 	/// Is kneeled?
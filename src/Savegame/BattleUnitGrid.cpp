@@ -0,0 +1,148 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "BattleUnitGrid.h"
+#include <algorithm>
+#include "BattleUnit.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Initializes a grid without any cells.
+ */
+BattleUnitGrid::BattleUnitGrid() : _width(0), _length(0)
+{
+}
+
+/**
+ *
+ */
+BattleUnitGrid::~BattleUnitGrid()
+{
+}
+
+/**
+ * Returns the cell containing a column of the map.
+ * @param x X coordinate, clamped to the map.
+ * @param y Y coordinate, clamped to the map.
+ * @return Cell index.
+ */
+int BattleUnitGrid::getCell(int x, int y) const
+{
+	int cx = std::max(0, std::min(x, _width * CELL_SIZE - 1)) / CELL_SIZE;
+	int cy = std::max(0, std::min(y, _length * CELL_SIZE - 1)) / CELL_SIZE;
+	return cy * _width + cx;
+}
+
+/**
+ * Sets up the cells to cover the whole map and empties them.
+ * The cells are reused if the map size did not change.
+ * @param mapsizeX Map width, in tiles.
+ * @param mapsizeY Map length, in tiles.
+ */
+void BattleUnitGrid::resize(int mapsizeX, int mapsizeY)
+{
+	int width = std::max(1, (mapsizeX + CELL_SIZE - 1) / CELL_SIZE);
+	int length = std::max(1, (mapsizeY + CELL_SIZE - 1) / CELL_SIZE);
+	if (width == _width && length == _length)
+	{
+		clear();
+		return;
+	}
+	_width = width;
+	_length = length;
+	_cells.clear();
+	_cells.resize(_width * _length);
+	_units.clear();
+}
+
+/**
+ * Empties all the cells, keeping their memory around
+ * so the grid can be cheaply rebuilt after units move.
+ */
+void BattleUnitGrid::clear()
+{
+	for (auto &cell : _cells)
+	{
+		cell.clear();
+	}
+	_units.clear();
+}
+
+/**
+ * Adds a unit to the grid. The grid does not track
+ * the unit afterwards, so it has to be rebuilt when
+ * units move. Units off the map are left out.
+ * @param unit Pointer to unit.
+ */
+void BattleUnitGrid::insert(BattleUnit *unit)
+{
+	Position pos = unit->getPosition();
+	if (_cells.empty() || pos.x < 0 || pos.y < 0)
+	{
+		return;
+	}
+	_cells[getCell(pos.x, pos.y)].push_back((int)_units.size());
+	_units.push_back(unit);
+}
+
+/**
+ * Returns all units in cells overlapping the square around
+ * a position. This is a superset of the units in range,
+ * callers still need to check the exact distance.
+ * @param center Position at the center of the range.
+ * @param range Range in tiles, ignoring height.
+ * @param result List to fill, in insertion order.
+ */
+void BattleUnitGrid::query(Position center, int range, std::vector<BattleUnit*> &result) const
+{
+	result.clear();
+	if (_units.empty() || range < 0)
+	{
+		return;
+	}
+
+	int x1 = getCell(center.x - range, 0);
+	int y1 = getCell(0, center.y - range) / _width;
+	int x2 = getCell(center.x + range, 0);
+	int y2 = getCell(0, center.y + range) / _width;
+	if ((x2 - x1 + 1) * (y2 - y1 + 1) == (int)_cells.size())
+	{
+		result = _units;
+		return;
+	}
+
+	std::vector<int> found;
+	for (int y = y1; y <= y2; ++y)
+	{
+		for (int x = x1; x <= x2; ++x)
+		{
+			const auto &v = _cells[y * _width + x];
+			found.insert(found.end(), v.begin(), v.end());
+		}
+	}
+
+	std::sort(found.begin(), found.end());
+	for (int i : found)
+	{
+		result.push_back(_units[i]);
+	}
+}
+
+}
@@ -0,0 +1,63 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vector>
+#include "../Battlescape/Position.h"
+
+namespace OpenXcom
+{
+
+class BattleUnit;
+
+/**
+ * Spatial index of the units on the battlescape.
+ * The map is split into square columns of cells, so range
+ * lookups only need to visit the cells overlapping the
+ * square around the query point.
+ * Range queries return units in insertion order, so callers
+ * that depend on the order of the unit list (eg. reaction
+ * fire or RNG calls) behave the same as with a linear scan.
+ */
+class BattleUnitGrid
+{
+private:
+	/// Width of a cell, in tiles.
+	static const int CELL_SIZE = 8;
+	int _width, _length;
+	std::vector<std::vector<int> > _cells;
+	std::vector<BattleUnit*> _units;
+
+	/// Gets the cell index of a column of the map.
+	int getCell(int x, int y) const;
+public:
+	/// Creates an empty grid.
+	BattleUnitGrid();
+	/// Cleans up the grid.
+	~BattleUnitGrid();
+	/// Sets the size of the map covered by the grid and empties it.
+	void resize(int mapsizeX, int mapsizeY);
+	/// Removes all units from the grid.
+	void clear();
+	/// Adds a unit to the grid at its current position.
+	void insert(BattleUnit *unit);
+	/// Gets the units that can be within range of a position.
+	void query(Position center, int range, std::vector<BattleUnit*> &result) const;
+};
+
+}
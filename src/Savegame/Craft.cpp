@@ -1010,6 +1010,25 @@ bool Craft::think()
 	return false;
 }
 
+/**
+ * Checks if the craft is just sitting somewhere, so
+ * its geoscape logic (movement, take-off, shield recharge)
+ * would not change anything.
+ * @return True if the craft is idle.
+ */
+bool Craft::isIdle() const
+{
+	if (_dest != 0 || _takeoff != 0 || isDestroyed())
+	{
+		return false;
+	}
+	if (_shield < _stats.shieldCapacity && _stats.shieldRechargeInGeoscape != 0)
+	{
+		return false;
+	}
+	return true;
+}
+
 /**
  * Checks the condition of all the craft's systems
  * to define its new status (eg. when arriving at base).
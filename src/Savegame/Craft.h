@@ -188,6 +188,8 @@ public:
 	UfoDetection detect(const Ufo *target, bool alreadyTracked) const;
 	/// Handles craft logic.
 	bool think();
+	/// Checks if the craft logic has nothing to update.
+	bool isIdle() const;
 	/// Does a craft full checkup.
 	void checkup();
 	/// Consumes the craft's fuel.
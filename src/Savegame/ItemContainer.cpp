@@ -26,7 +26,7 @@ namespace OpenXcom
 /**
  * Initializes an item container with no contents.
  */
-ItemContainer::ItemContainer()
+ItemContainer::ItemContainer() : _totalSize(0), _totalSizeValid(false)
 {
 }
 
@@ -44,6 +44,7 @@ ItemContainer::~ItemContainer()
 void ItemContainer::load(const YAML::Node &node)
 {
 	_qty = node.as< std::map<std::string, int> >(_qty);
+	_totalSizeValid = false;
 }
 
 /**
@@ -69,6 +70,7 @@ void ItemContainer::addItem(const std::string &id, int qty)
 		return;
 	}
 	_qty[id] += qty;
+	_totalSizeValid = false;
 }
 
 /**
@@ -101,6 +103,7 @@ void ItemContainer::removeItem(const std::string &id, int qty)
 		return;
 	}
 
+	_totalSizeValid = false;
 	if (qty < it->second)
 	{
 		it->second -= qty;
@@ -180,25 +183,35 @@ int ItemContainer::getTotalQuantity() const
 
 /**
  * Returns the total size of the items in the container.
+ * The items are only looked up again after the contents change,
+ * since the base stores are summed up all the time in the Basescape.
  * @param mod Pointer to mod.
  * @return Total item size.
  */
 double ItemContainer::getTotalSize(const Mod *mod) const
 {
-	double total = 0;
-	for (std::map<std::string, int>::const_iterator i = _qty.begin(); i != _qty.end(); ++i)
+	if (!_totalSizeValid)
 	{
-		total += mod->getItem(i->first, true)->getSize() * i->second;
+		double total = 0;
+		for (std::map<std::string, int>::const_iterator i = _qty.begin(); i != _qty.end(); ++i)
+		{
+			total += mod->getItem(i->first, true)->getSize() * i->second;
+		}
+		_totalSize = total;
+		_totalSizeValid = true;
 	}
-	return total;
+	return _totalSize;
 }
 
 /**
  * Returns all the items currently contained within.
+ * The contents may be changed through it, so the total size
+ * is counted again next time.
  * @return List of contents.
  */
 std::map<std::string, int> *ItemContainer::getContents()
 {
+	_totalSizeValid = false;
 	return &_qty;
 }
 
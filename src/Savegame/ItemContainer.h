@@ -36,6 +36,8 @@ class ItemContainer
 {
 private:
 	std::map<std::string, int> _qty;
+	mutable double _totalSize;
+	mutable bool _totalSizeValid;
 public:
 	/// Creates an empty item container.
 	ItemContainer();
@@ -63,6 +65,8 @@ public:
 	double getTotalSize(const Mod *mod) const;
 	/// Gets all the items in the container.
 	std::map<std::string, int> *getContents();
+	/// Gets all the items in the container, without changing them.
+	const std::map<std::string, int> *getContents() const { return &_qty; }
 };
 
 }
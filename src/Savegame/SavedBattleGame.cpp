@@ -59,7 +59,7 @@ namespace OpenXcom
  */
 SavedBattleGame::SavedBattleGame(Mod *rule, Language *lang) :
 	_battleState(0), _rule(rule), _mapsize_x(0), _mapsize_y(0), _mapsize_z(0), _selectedUnit(0),
-	_lastSelectedUnit(0), _pathfinding(0), _tileEngine(0), _enviroEffects(nullptr), _ecEnabledFriendly(false), _ecEnabledHostile(false), _ecEnabledNeutral(false),
+	_lastSelectedUnit(0), _unitGridDirty(true), _attractiveItemsDirty(true), _pathfinding(0), _tileEngine(0), _enviroEffects(nullptr), _ecEnabledFriendly(false), _ecEnabledHostile(false), _ecEnabledNeutral(false),
 	_globalShade(0), _side(FACTION_PLAYER), _turn(0), _bughuntMinTurn(20), _animFrame(0), _nameDisplay(false),
 	_debugMode(false), _bughuntMode(false), _aborted(false), _itemId(0), _objectiveType(-1), _objectivesDestroyed(0), _objectivesNeeded(0), _unitsFalling(false),
 	_cheating(false), _tuReserved(BA_NONE), _kneelReserved(false), _depth(0),
@@ -583,6 +583,7 @@ void SavedBattleGame::initMap(int mapsize_x, int mapsize_y, int mapsize_z, bool
 		_tiles.push_back(Tile(getTileCoords(i)));
 	}
 
+	_unitGridDirty = true;
 }
 
 /**
@@ -929,6 +930,30 @@ std::vector<BattleUnit*> *SavedBattleGame::getUnits()
 	return &_units;
 }
 
+/**
+ * Gets the units whose position can be within range of
+ * another position. This is a superset of the units in range,
+ * in the same order as the list of units, so callers
+ * still need to check the exact distance and unit state.
+ * The index is rebuilt first if any unit changed tiles.
+ * @param center Position at the center of the range.
+ * @param range Range in tiles, ignoring height.
+ * @param result List to fill.
+ */
+void SavedBattleGame::getUnitsInRange(Position center, int range, std::vector<BattleUnit*> &result)
+{
+	if (_unitGridDirty)
+	{
+		_unitGrid.resize(_mapsize_x, _mapsize_y);
+		for (auto *unit : _units)
+		{
+			_unitGrid.insert(unit);
+		}
+		_unitGridDirty = false;
+	}
+	_unitGrid.query(center, range, result);
+}
+
 /**
  * Gets the list of items.
  * @return Pointer to the list of items.
@@ -938,6 +963,31 @@ std::vector<BattleItem*> *SavedBattleGame::getItems()
 	return &_items;
 }
 
+/**
+ * Gets the items with an attraction value, wherever they are,
+ * in the same order as the list of items. Only a few item types
+ * attract the AI, so this is much shorter than the full list
+ * on long missions full of corpses and spent ammo.
+ * The list is rebuilt first if it was invalidated since the last call.
+ * @return List of items.
+ */
+const std::vector<BattleItem*> &SavedBattleGame::getAttractiveItems()
+{
+	if (_attractiveItemsDirty)
+	{
+		_attractiveItems.clear();
+		for (auto *item : _items)
+		{
+			if (item->getRules()->getAttraction())
+			{
+				_attractiveItems.push_back(item);
+			}
+		}
+		_attractiveItemsDirty = false;
+	}
+	return _attractiveItems;
+}
+
 /**
  * Gets the pathfinding object.
  * @return Pointer to the pathfinding object.
@@ -1432,6 +1482,7 @@ void SavedBattleGame::removeItem(BattleItem *item)
 	{
 		return;
 	}
+	_attractiveItemsDirty = true;
 
 	// due to strange design, the item has to be removed from the tile it is on too (if it is on a tile)
 	item->moveToOwner(nullptr);
@@ -1565,6 +1616,7 @@ BattleItem *SavedBattleGame::createItemForUnit(const RuleItem *rule, BattleUnit
 	else
 	{
 		_items.push_back(item);
+		_attractiveItemsDirty = true;
 		initItem(item, unit);
 	}
 	return item;
@@ -1600,6 +1652,7 @@ BattleItem *SavedBattleGame::createItemForTile(const RuleItem *rule, Tile *tile)
 		tile->addItem(item, ground);
 	}
 	_items.push_back(item);
+	_attractiveItemsDirty = true;
 	initItem(item);
 	return item;
 }
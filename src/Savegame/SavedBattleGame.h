@@ -21,6 +21,7 @@
 #include <string>
 #include <yaml-cpp/yaml.h>
 #include "Tile.h"
+#include "BattleUnitGrid.h"
 #include "../Mod/AlienDeployment.h"
 
 namespace OpenXcom
@@ -67,7 +68,11 @@ private:
 	BattleUnit *_selectedUnit, *_lastSelectedUnit;
 	std::vector<Node*> _nodes;
 	std::vector<BattleUnit*> _units;
+	BattleUnitGrid _unitGrid;
+	bool _unitGridDirty;
 	std::vector<BattleItem*> _items, _deleted;
+	std::vector<BattleItem*> _attractiveItems;
+	bool _attractiveItemsDirty;
 	Pathfinding *_pathfinding;
 	TileEngine *_tileEngine;
 	std::string _missionType, _strTarget, _strCraftOrBase, _alienCustomDeploy, _alienCustomMission;
@@ -158,8 +163,16 @@ public:
 	std::vector<Node*> *getNodes();
 	/// Gets a pointer to the list of items.
 	std::vector<BattleItem*> *getItems();
+	/// Gets the items the AI may want to pick up.
+	const std::vector<BattleItem*> &getAttractiveItems();
+	/// Marks the list of attractive items as outdated, call after changing getItems() directly.
+	void invalidateAttractiveItems() { _attractiveItemsDirty = true; }
 	/// Gets a pointer to the list of units.
 	std::vector<BattleUnit*> *getUnits();
+	/// Gets the units that can be within range of a position.
+	void getUnitsInRange(Position center, int range, std::vector<BattleUnit*> &result);
+	/// Marks the unit positions as changed.
+	void invalidateUnitGrid() { _unitGridDirty = true; }
 	/// Gets terrain size x.
 	int getMapSizeX() const;
 	/// Gets terrain size y.
@@ -114,21 +114,41 @@ bool equalProduction::operator()(const Production * p) const
 	return p->getRules() == _item;
 }
 
-bool researchLess(const RuleResearch *a, const RuleResearch *b)
+bool researchIndexLess(const RuleResearch *a, const RuleResearch *b)
 {
-	return std::less<const RuleResearch *>{}(a, b);
+	return a->getIndex() < b->getIndex();
 }
 
-template<typename T>
-void sortReserchVector(std::vector<T> &vec)
+bool getResearchBit(const std::vector<bool> &bits, const RuleResearch *res)
 {
-	std::sort(vec.begin(), vec.end(), researchLess);
+	size_t index = res->getIndex();
+	return index < bits.size() && bits[index];
 }
 
-bool haveReserchVector(const std::vector<const RuleResearch*> &vec, const RuleResearch *res)
+void setResearchBit(std::vector<bool> &bits, const RuleResearch *res, bool value)
 {
-	auto find = std::lower_bound(vec.begin(), vec.end(), res, researchLess);
-	return find != vec.end() && *find == res;
+	size_t index = res->getIndex();
+	if (index >= bits.size())
+	{
+		bits.resize(index + 1, false);
+	}
+	bits[index] = value;
+}
+
+int getResearchCount(const std::vector<int> &counts, const RuleResearch *res)
+{
+	size_t index = res->getIndex();
+	return index < counts.size() ? counts[index] : 0;
+}
+
+void addResearchCount(std::vector<int> &counts, const RuleResearch *res, int delta)
+{
+	size_t index = res->getIndex();
+	if (index >= counts.size())
+	{
+		counts.resize(index + 1, 0);
+	}
+	counts[index] += delta;
 }
 
 bool haveReserchVector(const std::vector<const RuleResearch*> &vec,  const std::string &res)
@@ -577,19 +597,26 @@ void SavedGame::load(const std::string &filename, Mod *mod, Language *lang)
 		std::string research = it->as<std::string>();
 		if (mod->getResearch(research))
 		{
-			_discovered.push_back(mod->getResearch(research));
+			setResearchDiscovered(mod->getResearch(research), true);
 		}
 		else
 		{
 			Log(LOG_ERROR) << "Failed to load research " << research;
 		}
 	}
-	sortReserchVector(_discovered);
 
 	_generatedEvents = doc["generatedEvents"].as< std::map<std::string, int> >(_generatedEvents);
 	_ufopediaRuleStatus = doc["ufopediaRuleStatus"].as< std::map<std::string, int> >(_ufopediaRuleStatus);
 	_manufactureRuleStatus = doc["manufactureRuleStatus"].as< std::map<std::string, int> >(_manufactureRuleStatus);
 	_researchRuleStatus = doc["researchRuleStatus"].as< std::map<std::string, int> >(_researchRuleStatus);
+	for (const auto &status : _researchRuleStatus)
+	{
+		const RuleResearch *research = mod->getResearch(status.first);
+		if (research && status.second == RuleResearch::RESEARCH_STATUS_DISABLED)
+		{
+			setResearchBit(_researchDisabled, research, true);
+		}
+	}
 	_hiddenPurchaseItemsMap = doc["hiddenPurchaseItems"].as< std::map<std::string, bool> >(_hiddenPurchaseItemsMap);
 
 	for (YAML::const_iterator i = doc["bases"].begin(); i != doc["bases"].end(); ++i)
@@ -1419,11 +1446,7 @@ const std::map<std::string, bool> &SavedGame::getHiddenPurchaseItems()
  */
 void SavedGame::removeDiscoveredResearch(const RuleResearch * research)
 {
-	std::vector<const RuleResearch*>::iterator r = std::find(_discovered.begin(), _discovered.end(), research);
-	if (r != _discovered.end())
-	{
-		_discovered.erase(r);
-	}
+	setResearchDiscovered(research, false);
 }
 
 /**
@@ -1432,8 +1455,55 @@ void SavedGame::removeDiscoveredResearch(const RuleResearch * research)
  */
 void SavedGame::addFinishedResearchSimple(const RuleResearch * research)
 {
-	_discovered.push_back(research);
-	sortReserchVector(_discovered);
+	setResearchDiscovered(research, true);
+}
+
+/**
+ * Adds or removes a research in the discovered list, and updates the
+ * counters of the topics it unlocks or that depend on it, so
+ * getAvailableResearchProjects() can check each topic in constant time.
+ * @param research The research.
+ * @param discovered Should it be discovered or not?
+ */
+void SavedGame::setResearchDiscovered(const RuleResearch *research, bool discovered)
+{
+	if (getResearchBit(_researchDiscovered, research) == discovered)
+	{
+		return;
+	}
+	setResearchBit(_researchDiscovered, research, discovered);
+	if (discovered)
+	{
+		_discovered.push_back(research);
+	}
+	else
+	{
+		_discovered.erase(std::find(_discovered.begin(), _discovered.end(), research));
+	}
+
+	const int delta = discovered ? 1 : -1;
+	for (auto *r : research->getUnlocked())
+	{
+		addResearchCount(_researchUnlocks, r, delta);
+	}
+	for (auto *r : research->getDependents())
+	{
+		addResearchCount(_researchDependenciesMet, r, delta);
+	}
+	for (auto *r : research->getRequiredBy())
+	{
+		addResearchCount(_researchRequirementsMet, r, delta);
+	}
+}
+
+/**
+ * Marks a research as permanently disabled.
+ * @param research The research.
+ */
+void SavedGame::disableResearch(const RuleResearch *research)
+{
+	setResearchRuleStatus(research->getName(), RuleResearch::RESEARCH_STATUS_DISABLED);
+	setResearchBit(_researchDisabled, research, true);
 }
 
 /**
@@ -1445,7 +1515,7 @@ void SavedGame::addFinishedResearchSimple(const RuleResearch * research)
  */
 void SavedGame::addFinishedResearch(const RuleResearch * research, const Mod * mod, Base * base, bool score)
 {
-	if (isResearchRuleStatusDisabled(research->getName()))
+	if (isResearchDisabled(research))
 	{
 		// make absolutely sure disabled research never gets re-researched again by accident
 		return;
@@ -1468,8 +1538,7 @@ void SavedGame::addFinishedResearch(const RuleResearch * research, const Mod * m
 		bool checkRelatedZeroCostTopics = true;
 		if (!isResearched(currentQueueItem, false))
 		{
-			_discovered.push_back(currentQueueItem);
-			sortReserchVector(_discovered);
+			setResearchDiscovered(currentQueueItem, true);
 			if (!hasUndiscoveredProtectedUnlocks && !hasAnyUndiscoveredGetOneFrees)
 			{
 				// If the currentQueueItem can't tell you anything anymore, remove it from popped research
@@ -1485,7 +1554,7 @@ void SavedGame::addFinishedResearch(const RuleResearch * research, const Mod * m
 			for (auto& dis : currentQueueItem->getDisabled())
 			{
 				removeDiscoveredResearch(dis); // unresearch
-				setResearchRuleStatus(dis->getName(), RuleResearch::RESEARCH_STATUS_DISABLED); // mark as permanently disabled
+				disableResearch(dis); // mark as permanently disabled
 			}
 		}
 		else
@@ -1582,37 +1651,29 @@ const std::vector<const RuleResearch *> & SavedGame::getDiscoveredResearch() con
  */
 void SavedGame::getAvailableResearchProjects(std::vector<RuleResearch *> &projects, const Mod *mod, Base *base, bool considerDebugMode) const
 {
-	// This list is used for topics that can be researched even if *not all* dependencies have been discovered yet (e.g. STR_ALIEN_ORIGINS)
-	// Note: all requirements of such topics *have to* be discovered though! This will be handled elsewhere.
-	std::vector<const RuleResearch *> unlocked;
-	for (const RuleResearch *research : _discovered)
-	{
-		for (auto& itUnlocked : research->getUnlocked())
-		{
-			unlocked.push_back(itUnlocked);
-		}
-		sortReserchVector(unlocked);
-	}
+	const bool debug = considerDebugMode && _debug;
 
 	// Create a list of research topics available for research in the given base
 	for (auto& pair : mod->getResearchMap())
 	{
+		RuleResearch *research = pair.second;
+
 		// This research topic is permanently disabled, ignore it!
-		if (isResearchRuleStatusDisabled(pair.first))
+		if (isResearchDisabled(research))
 		{
 			continue;
 		}
 
-		RuleResearch *research = pair.second;
-
-		if ((considerDebugMode && _debug) || haveReserchVector(unlocked, research))
+		// Topics unlocked by a discovered topic can be researched even if *not all* dependencies have been discovered yet (e.g. STR_ALIEN_ORIGINS)
+		// Note: all requirements of such topics *have to* be discovered though! This will be handled below.
+		if (debug || getResearchCount(_researchUnlocks, research) > 0)
 		{
 			// Empty, these research topics are on the "unlocked list", *don't* check the dependencies!
 		}
 		else
 		{
 			// These items are not on the "unlocked list", we must check if "dependencies" are satisfied!
-			if (!isResearched(research->getDependencies(), considerDebugMode))
+			if (getResearchCount(_researchDependenciesMet, research) < (int)research->getDependencies().size())
 			{
 				continue;
 			}
@@ -1624,13 +1685,13 @@ void SavedGame::getAvailableResearchProjects(std::vector<RuleResearch *> &projec
 		//   - there is an additional filter in NewPossibleResearchState::NewPossibleResearchState()
 		//   - we do this check for other functionality using this method, namely SavedGame::addFinishedResearch()
 		//     - Note: when called from there, parameter considerDebugMode = false
-		if (!isResearched(research->getRequirements(), considerDebugMode))
+		if (!debug && getResearchCount(_researchRequirementsMet, research) < (int)research->getRequirements().size())
 		{
 			continue;
 		}
 
 		// Remove the already researched topics from the list *UNLESS* they can still give you something more
-		if (isResearched(research->getName(), false))
+		if (isResearched(research, false))
 		{
 			if (hasUndiscoveredGetOneFree(research, true))
 			{
@@ -1697,12 +1758,9 @@ void SavedGame::getNewlyAvailableResearchProjects(std::vector<RuleResearch *> &
 	// c/ wrong: could end in an endless loop! in two different ways! (not in vanilla, but in mods)
 
 	// Note:
-	// We could move the sorting of "before" vector right after its creation to optimize a little bit more.
-	// But sorting a short list is negligible compared to other operations we had to do to get to this point.
-	// So I decided to leave it here, so that it's 100% clear what's going on.
-	sortReserchVector(before);
-	sortReserchVector(after);
-	std::set_difference(after.begin(), after.end(), before.begin(), before.end(), std::inserter(diff, diff.begin()), researchLess);
+	// Both lists come from getAvailableResearchProjects(), which returns topics in research index order,
+	// so they are already sorted and the difference is a single pass over both.
+	std::set_difference(after.begin(), after.end(), before.begin(), before.end(), std::inserter(diff, diff.begin()), researchIndexLess);
 }
 
 /**
@@ -1754,20 +1812,17 @@ void SavedGame::getAvailableProductions (std::vector<RuleManufacture *> & produc
  */
 void SavedGame::getDependableManufacture (std::vector<RuleManufacture *> & dependables, const RuleResearch *research, const Mod * mod, Base *) const
 {
-	const std::vector<std::string> &mans = mod->getManufactureList();
-	for (std::vector<std::string>::const_iterator iter = mans.begin(); iter != mans.end(); ++iter)
+	for (RuleManufacture *m : mod->getResearchDependents(research).manufacture)
 	{
 		// don't show previously unlocked (and seen!) manufacturing topics
-		std::map<std::string, int>::const_iterator i = _manufactureRuleStatus.find(*iter);
+		std::map<std::string, int>::const_iterator i = _manufactureRuleStatus.find(m->getName());
 		if (i != _manufactureRuleStatus.end())
 		{
 			if (i->second != RuleManufacture::MANU_STATUS_NEW)
 				continue;
 		}
 
-		RuleManufacture *m = mod->getManufacture(*iter);
-		const auto &reqs = m->getRequirements();
-		if (isResearched(reqs) && std::find(reqs.begin(), reqs.end(), research) != reqs.end())
+		if (isResearched(m->getRequirements()))
 		{
 			dependables.push_back(m);
 		}
@@ -1809,22 +1864,13 @@ void SavedGame::getAvailableTransformations (std::vector<RuleSoldierTransformati
  */
 void SavedGame::getDependablePurchase(std::vector<RuleItem *> & dependables, const RuleResearch *research, const Mod * mod) const
 {
-	const std::vector<std::string> &itemlist = mod->getItemsList();
-	for (std::vector<std::string>::const_iterator iter = itemlist.begin(); iter != itemlist.end(); ++iter)
+	for (RuleItem *item : mod->getResearchDependents(research).items)
 	{
-		RuleItem *item = mod->getItem(*iter);
 		if (item->getBuyCost() != 0)
 		{
-			const std::vector<const RuleResearch *> &reqs = item->getRequirements();
-			bool found = std::find(reqs.begin(), reqs.end(), research) != reqs.end();
-			const std::vector<const RuleResearch *> &reqsBuy = item->getBuyRequirements();
-			bool foundBuy = std::find(reqsBuy.begin(), reqsBuy.end(), research) != reqsBuy.end();
-			if (found || foundBuy)
+			if (isResearched(item->getBuyRequirements()) && isResearched(item->getRequirements()))
 			{
-				if (isResearched(item->getBuyRequirements()) && isResearched(item->getRequirements()))
-				{
-					dependables.push_back(item);
-				}
+				dependables.push_back(item);
 			}
 		}
 	}
@@ -1838,19 +1884,13 @@ void SavedGame::getDependablePurchase(std::vector<RuleItem *> & dependables, con
  */
 void SavedGame::getDependableCraft(std::vector<RuleCraft *> & dependables, const RuleResearch *research, const Mod * mod) const
 {
-	const std::vector<std::string> &craftlist = mod->getCraftsList();
-	for (std::vector<std::string>::const_iterator iter = craftlist.begin(); iter != craftlist.end(); ++iter)
+	for (RuleCraft *craftItem : mod->getResearchDependents(research).crafts)
 	{
-		RuleCraft *craftItem = mod->getCraft(*iter);
 		if (craftItem->getBuyCost() != 0)
 		{
-			const std::vector<std::string> &reqs = craftItem->getRequirements();
-			if (std::find(reqs.begin(), reqs.end(), research->getName()) != reqs.end())
+			if (isResearched(craftItem->getRequirements()))
 			{
-				if (isResearched(craftItem->getRequirements()))
-				{
-					dependables.push_back(craftItem);
-				}
+				dependables.push_back(craftItem);
 			}
 		}
 	}
@@ -1864,17 +1904,11 @@ void SavedGame::getDependableCraft(std::vector<RuleCraft *> & dependables, const
  */
 void SavedGame::getDependableFacilities(std::vector<RuleBaseFacility *> & dependables, const RuleResearch *research, const Mod * mod) const
 {
-	const std::vector<std::string> &facilitylist = mod->getBaseFacilitiesList();
-	for (std::vector<std::string>::const_iterator iter = facilitylist.begin(); iter != facilitylist.end(); ++iter)
+	for (RuleBaseFacility *facilityItem : mod->getResearchDependents(research).facilities)
 	{
-		RuleBaseFacility *facilityItem = mod->getBaseFacility(*iter);
-		const std::vector<std::string> &reqs = facilityItem->getRequirements();
-		if (std::find(reqs.begin(), reqs.end(), research->getName()) != reqs.end())
+		if (isResearched(facilityItem->getRequirements()))
 		{
-			if (isResearched(facilityItem->getRequirements()))
-			{
-				dependables.push_back(facilityItem);
-			}
+			dependables.push_back(facilityItem);
 		}
 	}
 }
@@ -1935,6 +1969,16 @@ bool SavedGame::isResearchRuleStatusDisabled(const std::string &researchRule) co
 	return false;
 }
 
+/**
+ * Is the research permanently disabled?
+ * @param research The research.
+ * @return True, if the research is disabled.
+ */
+bool SavedGame::isResearchDisabled(const RuleResearch *research) const
+{
+	return getResearchBit(_researchDisabled, research);
+}
+
 /**
  * Returns if a research still has undiscovered non-disabled "getOneFree".
  * @param r Research to check.
@@ -1979,7 +2023,7 @@ bool SavedGame::hasUndiscoveredProtectedUnlock(const RuleResearch * r, const Mod
 	// Note: checking for not yet discovered unlocks protected by "requires" (which also implies cost = 0)
 	for (auto& unlock : r->getUnlocked())
 	{
-		if (isResearchRuleStatusDisabled(unlock->getName()))
+		if (isResearchDisabled(unlock))
 		{
 			// ignore all disabled topics (as if they didn't exist)
 			continue;
@@ -2018,7 +2062,7 @@ bool SavedGame::isResearched(const RuleResearch *research, bool considerDebugMod
 	if (considerDebugMode && _debug)
 		return true;
 
-	return haveReserchVector(_discovered, research);
+	return getResearchBit(_researchDiscovered, research);
 }
 
 bool SavedGame::isResearched(const std::vector<std::string> &research, bool considerDebugMode) const
@@ -2052,26 +2096,14 @@ bool SavedGame::isResearched(const std::vector<const RuleResearch *> &research,
 		return true;
 	if (considerDebugMode && _debug)
 		return true;
-	std::vector<const RuleResearch *> matches = research;
-	if (skipDisabled)
+	for (auto& r : research)
 	{
-		// ignore all disabled topics (as if they didn't exist)
-		for (std::vector<const RuleResearch *>::iterator j = matches.begin(); j != matches.end();)
+		if (skipDisabled && isResearchDisabled(r))
 		{
-			if (isResearchRuleStatusDisabled((*j)->getName()))
-			{
-				j = matches.erase(j);
-			}
-			else
-			{
-				++j;
-			}
+			// ignore all disabled topics (as if they didn't exist)
+			continue;
 		}
-	}
-
-	for (auto& r : matches)
-	{
-		if (!haveReserchVector(_discovered, r))
+		if (!getResearchBit(_researchDiscovered, r))
 		{
 			return false;
 		}
@@ -145,6 +145,9 @@ private:
 	AlienStrategy *_alienStrategy;
 	SavedBattleGame *_battleGame;
 	std::vector<const RuleResearch*> _discovered;
+	// by RuleResearch::getIndex(), grown as needed
+	std::vector<bool> _researchDiscovered, _researchDisabled;
+	std::vector<int> _researchUnlocks, _researchDependenciesMet, _researchRequirementsMet;
 	std::map<std::string, int> _generatedEvents;
 	std::map<std::string, int> _ufopediaRuleStatus;
 	std::map<std::string, int> _manufactureRuleStatus;
@@ -174,6 +177,12 @@ private:
 	ScriptValues<SavedGame> _scriptValues;
 
 	static SaveInfo getSaveInfo(const std::string &file, Language *lang);
+	/// Marks a research as discovered or not, and updates the topics depending on it.
+	void setResearchDiscovered(const RuleResearch *research, bool discovered);
+	/// Permanently disables a research.
+	void disableResearch(const RuleResearch *research);
+	/// Is the research permanently disabled?
+	bool isResearchDisabled(const RuleResearch *research) const;
 public:
 	static const std::string AUTOSAVE_GEOSCAPE, AUTOSAVE_BATTLESCAPE, QUICKSAVE;
 	/// Creates a new saved game.
@@ -0,0 +1,204 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "TargetGrid.h"
+#include <algorithm>
+#include <cmath>
+#include "Target.h"
+#include "../fmath.h"
+
+namespace OpenXcom
+{
+
+namespace
+{
+
+/**
+ * Brings a longitude into the [0, 2PI) range.
+ */
+double normalizeLongitude(double lon)
+{
+	lon = std::fmod(lon, 2 * M_PI);
+	if (lon < 0)
+		lon += 2 * M_PI;
+	return lon;
+}
+
+}
+
+/**
+ * Sets up the cells of the grid.
+ * @param cellSize Approximate size of a cell, in radians.
+ */
+TargetGrid::TargetGrid(double cellSize)
+{
+	int bands = std::max(1, (int)std::ceil(M_PI / cellSize));
+	_cellSize = M_PI / bands;
+	int total = 0;
+	for (int b = 0; b < bands; ++b)
+	{
+		double center = -M_PI / 2 + (b + 0.5) * _cellSize;
+		int cells = std::max(1, (int)(2 * M_PI * std::cos(center) / _cellSize));
+		_bandOffset.push_back(total);
+		_bandCells.push_back(cells);
+		total += cells;
+	}
+	_cells.resize(total);
+}
+
+/**
+ *
+ */
+TargetGrid::~TargetGrid()
+{
+}
+
+/**
+ * Returns the latitude band containing a latitude.
+ * @param lat Latitude in radian.
+ * @return Band index.
+ */
+int TargetGrid::getBand(double lat) const
+{
+	int band = (int)std::floor((lat + M_PI / 2) / _cellSize);
+	return Clamp(band, 0, (int)_bandCells.size() - 1);
+}
+
+/**
+ * Returns the cell containing a longitude in a given band.
+ * @param band Band index.
+ * @param lon Longitude in radian, between 0 and 2xPI.
+ * @return Cell index.
+ */
+int TargetGrid::getCell(int band, double lon) const
+{
+	int cells = _bandCells[band];
+	int cell = std::min((int)(lon * cells / (2 * M_PI)), cells - 1);
+	return _bandOffset[band] + cell;
+}
+
+/**
+ * Empties all the cells, keeping their memory around
+ * so the grid can be cheaply rebuilt every tick.
+ */
+void TargetGrid::clear()
+{
+	for (auto &cell : _cells)
+	{
+		cell.clear();
+	}
+	_entries.clear();
+}
+
+/**
+ * Adds a target to the grid. The grid does not track
+ * the target afterwards, so it has to be rebuilt when
+ * targets move.
+ * @param target Pointer to target.
+ */
+void TargetGrid::insert(Target *target)
+{
+	Entry e = { target, normalizeLongitude(target->getLongitude()), target->getLatitude() };
+	_cells[getCell(getBand(e.lat), e.lon)].push_back((int)_entries.size());
+	_entries.push_back(e);
+}
+
+/**
+ * Returns all targets in cells overlapping the spherical cap
+ * around a position. This is a superset of the targets
+ * in range, callers still need to check the exact distance.
+ * @param lon Longitude in radian.
+ * @param lat Latitude in radian.
+ * @param range Range in radian.
+ * @param result List to fill, in insertion order.
+ */
+void TargetGrid::query(double lon, double lat, double range, std::vector<Target*> &result) const
+{
+	result.clear();
+	if (_entries.empty() || range < 0)
+	{
+		return;
+	}
+
+	// small margin so targets exactly on the edge are never missed
+	range += 1e-9;
+	if (range >= M_PI)
+	{
+		for (auto &e : _entries)
+		{
+			result.push_back(e.target);
+		}
+		return;
+	}
+
+	lon = normalizeLongitude(lon);
+	double latMin = lat - range;
+	double latMax = lat + range;
+	double spread = M_PI;
+	if (latMin > -M_PI / 2 && latMax < M_PI / 2)
+	{
+		// widest longitude difference of a cap that does not contain a pole
+		double s = std::sin(range) / std::cos(lat);
+		if (s < 1.0)
+		{
+			spread = std::asin(s);
+		}
+	}
+
+	std::vector<int> found;
+	for (int b = getBand(latMin), last = getBand(latMax); b <= last; ++b)
+	{
+		int cells = _bandCells[b];
+		int first = 0, count = cells;
+		if (spread < M_PI)
+		{
+			first = (int)std::floor((lon - spread) * cells / (2 * M_PI));
+			count = (int)std::floor((lon + spread) * cells / (2 * M_PI)) - first + 1;
+			if (count > cells)
+			{
+				first = 0;
+				count = cells;
+			}
+		}
+		for (int i = 0; i < count; ++i)
+		{
+			int cell = ((first + i) % cells + cells) % cells;
+			const auto &v = _cells[_bandOffset[b] + cell];
+			found.insert(found.end(), v.begin(), v.end());
+		}
+	}
+
+	std::sort(found.begin(), found.end());
+	for (int i : found)
+	{
+		result.push_back(_entries[i].target);
+	}
+}
+
+/**
+ * Returns all targets that can be within range of another target.
+ * @param center Pointer to target at the center of the range.
+ * @param range Range in radian.
+ * @param result List to fill, in insertion order.
+ */
+void TargetGrid::query(const Target *center, double range, std::vector<Target*> &result) const
+{
+	query(center->getLongitude(), center->getLatitude(), range, result);
+}
+
+}
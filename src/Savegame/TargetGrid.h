@@ -0,0 +1,81 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstddef>
+#include <vector>
+
+namespace OpenXcom
+{
+
+class Target;
+
+/**
+ * Spatial index of targets on the globe.
+ * The sphere is split into latitude bands, and every band
+ * into longitude cells of roughly equal area, so range
+ * lookups only need to visit the cells overlapping the
+ * spherical cap around the query point.
+ * Range queries return targets in insertion order, so callers
+ * that depend on the order of the original list (eg. tie-breaking
+ * or RNG calls) behave the same as with a linear scan.
+ */
+class TargetGrid
+{
+private:
+	struct Entry
+	{
+		Target *target;
+		double lon, lat;
+	};
+	double _cellSize;
+	std::vector<int> _bandOffset, _bandCells;
+	std::vector<std::vector<int> > _cells;
+	std::vector<Entry> _entries;
+
+	/// Gets the latitude band of a latitude.
+	int getBand(double lat) const;
+	/// Gets the cell of a longitude in a given band.
+	int getCell(int band, double lon) const;
+public:
+	/// Creates an empty grid with the given cell size.
+	TargetGrid(double cellSize);
+	/// Cleans up the grid.
+	~TargetGrid();
+	/// Removes all targets from the grid.
+	void clear();
+	/// Adds a target to the grid at its current position.
+	void insert(Target *target);
+	/// Adds a list of targets to the grid.
+	template<typename T>
+	void insert(const std::vector<T*> &targets)
+	{
+		for (auto *t : targets)
+		{
+			insert(t);
+		}
+	}
+	/// Gets the number of targets in the grid.
+	std::size_t size() const { return _entries.size(); }
+	/// Gets the targets that can be within range of a position.
+	void query(double lon, double lat, double range, std::vector<Target*> &result) const;
+	/// Gets the targets that can be within range of another target.
+	void query(const Target *center, double range, std::vector<Target*> &result) const;
+};
+
+}
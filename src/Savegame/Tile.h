@@ -108,7 +108,7 @@ public:
 
 protected:
 	MapData *_objects[O_MAX];
-	std::unique_ptr<TileMapDataCache> _mapData = std::make_unique<TileMapDataCache>();
+	TileMapDataCache _mapData;
 	SurfaceRaw<const Uint8> _currentSurface[O_MAX] = { };
 	TileObjectCache _objectsCache[O_MAX] = { };
 	TileCache _cache = { };
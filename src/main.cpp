@@ -116,6 +116,13 @@ int main(int argc, char *argv[])
 	title << "OpenXcom " << OPENXCOM_VERSION_SHORT << OPENXCOM_VERSION_GIT;
 	Options::baseXResolution = Options::displayWidth;
 	Options::baseYResolution = Options::displayHeight;
+	if (!Options::getBenchmark().empty())
+	{
+		// benchmarks don't need a window or sound
+		SDL_putenv(const_cast<char*>("SDL_VIDEODRIVER=dummy"));
+		SDL_putenv(const_cast<char*>("SDL_AUDIODRIVER=dummy"));
+		Options::useOpenGL = false;
+	}
 
 	game = new Game(title.str());
 	State::setGamePtr(game);